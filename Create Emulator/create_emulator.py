@@ -0,0 +1,861 @@
+#!/usr/bin/env python
+#Emulates an iRobot Create (Open Interface v2) on a pseudo-terminal
+#
+#The emulator answers the same bytes the robot's USART1 sends to the Create,
+#so anything that speaks the protocol in open_interface.c can run against it
+#without hardware. It models wheel kinematics, bumpers, cliff and line
+#signals, the dock and battery drain in a small rectangular world.
+#
+#Usage:
+#	python create_emulator.py [--link /tmp/create] [--timing paced] [--world world.json]
+#	python create_emulator.py --bench      (measures poll latency and stream throughput)
+#
+#Timing fidelity:
+#	ideal    replies are written as soon as a command is complete
+#	paced    bytes leave at the emulated baud rate (10 bits per byte) after
+#	         --latency ms, so link throughput and poll latency are realistic
+#	--time-scale runs the world (and the link, when paced) faster or slower
+#
+#The emulator prints its link statistics when it exits (Ctrl-C), and writes
+#them as JSON to --stats when given, for regression tests.
+
+from __future__ import print_function, division
+
+import argparse
+import json
+import math
+import os
+import pty
+import select
+import signal
+import struct
+import sys
+import termios
+import threading
+import time
+import tty
+
+#Open Interface opcodes, as in open_interface.h
+START = 128
+BAUD = 129
+CONTROL = 130
+SAFE = 131
+FULL = 132
+POWER = 133
+SPOT = 134
+CLEAN = 135
+DEMO = 136        #OI_OPCODE_MAX in open_interface.h; the Create runs a demo
+DRIVE = 137
+MOTORS = 138
+LEDS = 139
+SONG = 140
+PLAY = 141
+SENSORS = 142
+FORCEDOCK = 143
+PWM_MOTORS = 144
+DRIVE_WHEELS = 145
+DRIVE_PWM = 146
+OUTPUTS = 147
+STREAM = 148
+QUERY_LIST = 149
+DO_STREAM = 150
+SEND_IR_CHAR = 151
+SCRIPT = 152
+PLAY_SCRIPT = 153
+SHOW_SCRIPT = 154
+WAIT_TIME = 155
+WAIT_DISTANCE = 156
+WAIT_ANGLE = 157
+WAIT_EVENT = 158
+
+#Number of data bytes after each opcode; None means the length is in the data
+ARGUMENTS = {
+	START: 0, BAUD: 1, CONTROL: 0, SAFE: 0, FULL: 0, POWER: 0, SPOT: 0,
+	CLEAN: 0, DEMO: 1, DRIVE: 4, MOTORS: 1, LEDS: 3, SONG: None, PLAY: 1,
+	SENSORS: 1, FORCEDOCK: 0, PWM_MOTORS: 3, DRIVE_WHEELS: 4, DRIVE_PWM: 4,
+	OUTPUTS: 1, STREAM: None, QUERY_LIST: None, DO_STREAM: 1,
+	SEND_IR_CHAR: 1, SCRIPT: None, PLAY_SCRIPT: 0, SHOW_SCRIPT: 0,
+	WAIT_TIME: 1, WAIT_DISTANCE: 2, WAIT_ANGLE: 2, WAIT_EVENT: 1,
+}
+
+#OI modes (packet 35)
+MODE_OFF = 0
+MODE_PASSIVE = 1
+MODE_SAFE = 2
+MODE_FULL = 3
+
+#Baud codes 0-11
+BAUD_RATES = [300, 600, 1200, 2400, 4800, 9600, 14400, 19200, 28800, 38400, 57600, 115200]
+BAUD_POWER_UP = 57600
+
+#Packet sizes and whether they are signed, for packets 7-42
+PACKETS = {
+	7: (1, False), 8: (1, False), 9: (1, False), 10: (1, False),
+	11: (1, False), 12: (1, False), 13: (1, False), 14: (1, False),
+	15: (1, False), 16: (1, False), 17: (1, False), 18: (1, False),
+	19: (2, True), 20: (2, True), 21: (1, False), 22: (2, False),
+	23: (2, True), 24: (1, True), 25: (2, False), 26: (2, False),
+	27: (2, False), 28: (2, False), 29: (2, False), 30: (2, False),
+	31: (2, False), 32: (1, False), 33: (2, False), 34: (1, False),
+	35: (1, False), 36: (1, False), 37: (1, False), 38: (1, False),
+	39: (2, True), 40: (2, True), 41: (2, True), 42: (2, True),
+}
+#Groups 0-6 as (first, last) packet
+GROUPS = [(7, 26), (7, 16), (17, 20), (21, 26), (27, 34), (35, 42), (7, 42)]
+
+#Robot geometry in mm
+WHEEL_BASE = 258.0
+BODY_RADIUS = 165.0
+#Cliff sensors as (angle from the front in degrees, distance from the center)
+CLIFF_SENSORS = [(65.0, 140.0), (20.0, 155.0), (-20.0, 155.0), (-65.0, 140.0)]
+#The Create updates its sensors every 15 ms
+SENSOR_PERIOD = 0.015
+#Largest script the Create stores
+SCRIPT_MAX = 100
+#Battery
+CAPACITY = 2702
+IDLE_CURRENT = -250
+MOTOR_CURRENT = -1000
+CHARGE_CURRENT = 1500
+
+#Default world: a 4 m square room with a tape boundary, two posts, a hole and a dock
+DEFAULT_WORLD = {
+	"size": [4000, 4000],
+	"start": [600, 600, 90],
+	"obstacles": [[1800, 1800, 1900, 1900], [2800, 1000, 2900, 1100]],
+	"cliffs": [[3000, 2800, 3400, 3200]],
+	"lines": [[200, 200, 3800, 250], [200, 3750, 3800, 3800],
+	          [200, 200, 250, 3800], [3750, 200, 3800, 3800]],
+	"dock": [2000, 3700, 270],
+	"floor": 300,
+	"tape": 1200,
+}
+
+
+def clamp(value, low, high):
+	return max(low, min(high, value))
+
+
+def signed16(high, low):
+	return struct.unpack(">h", bytes(bytearray([high, low])))[0]
+
+
+def inside(rect, x, y):
+	return rect[0] <= x <= rect[2] and rect[1] <= y <= rect[3]
+
+
+#Returns the point of a rectangle closest to (x, y)
+def closest(rect, x, y):
+	return clamp(x, rect[0], rect[2]), clamp(y, rect[1], rect[3])
+
+
+def angle_diff(a, b):
+	return (a - b + math.pi) % (2 * math.pi) - math.pi
+
+
+#Everything the Create knows about itself and its surroundings
+class Create(object):
+	def __init__(self, world, charge=CAPACITY, drain_scale=1.0, noise=0):
+		self.world = world
+		self.drain_scale = drain_scale
+		self.noise = noise
+		self.x, self.y = float(world["start"][0]), float(world["start"][1])
+		self.heading = math.radians(world["start"][2])
+		self.mode = MODE_OFF
+		self.baud = BAUD_POWER_UP
+		self.right = 0.0      #wheel velocities in mm/s
+		self.left = 0.0
+		self.requested = [0, 0, 0, 0]   #packets 39-42
+		self.distance = 0.0   #since the last read of packet 19
+		self.angle = 0.0      #since the last read of packet 20
+		self.bumps = 0
+		self.drops = 0
+		self.overcurrents = 0
+		self.stalled = 0.0
+		self.charge = float(charge)
+		self.current = IDLE_CURRENT
+		self.charging_state = 0
+		self.charging_sources = 0
+		self.leds = [0, 0, 0]
+		self.songs = {}
+		self.song_number = 0
+		self.song_end = 0.0
+		self.stream_ids = []
+		self.streaming = False
+		self.script = bytearray()
+		self.sim_time = 0.0
+		self.seed = 12345
+
+	#Small deterministic noise for analog signals
+	def jitter(self):
+		if not self.noise:
+			return 0
+		self.seed = (self.seed * 1103515245 + 12345) & 0x7FFFFFFF
+		return (self.seed >> 16) % (2 * self.noise + 1) - self.noise
+
+	def walls(self):
+		w, h = self.world["size"]
+		border = [[-1000, -1000, 0, h + 1000], [w, -1000, w + 1000, h + 1000],
+		          [-1000, -1000, w + 1000, 0], [-1000, h, w + 1000, h + 1000]]
+		return border + self.world.get("obstacles", [])
+
+	#Distance between the body and the nearest wall or obstacle
+	def clearance(self, x, y):
+		return min(math.hypot(*[a - b for a, b in zip(closest(rect, x, y), (x, y))])
+		           for rect in self.walls()) - BODY_RADIUS
+
+	#Returns the bump bits for the body at (x, y, heading)
+	def contact(self, x, y, heading):
+		bits = 0
+		for rect in self.walls():
+			cx, cy = closest(rect, x, y)
+			if math.hypot(cx - x, cy - y) >= BODY_RADIUS:
+				continue
+			side = math.degrees(angle_diff(math.atan2(cy - y, cx - x), heading))
+			if abs(side) <= 10:
+				bits |= 3
+			elif 0 < side <= 90:
+				bits |= 2
+			elif -90 <= side < 0:
+				bits |= 1
+		return bits
+
+	def floor_signal(self, x, y):
+		for rect in self.world.get("cliffs", []):
+			if inside(rect, x, y):
+				return 0
+		for rect in self.world.get("lines", []):
+			if inside(rect, x, y):
+				return self.world.get("tape", 1200)
+		return self.world.get("floor", 300)
+
+	def cliff_signals(self):
+		signals = []
+		for angle, radius in CLIFF_SENSORS:
+			a = self.heading + math.radians(angle)
+			signal = self.floor_signal(self.x + radius * math.cos(a), self.y + radius * math.sin(a))
+			signals.append(clamp(signal + self.jitter(), 0, 4095) if signal else 0)
+		return signals
+
+	#Right side wall sensor; strongest when a wall is right next to the body
+	def wall_signal(self):
+		a = self.heading - math.pi / 2
+		for d in range(0, 101, 5):
+			r = BODY_RADIUS + d
+			px, py = self.x + r * math.cos(a), self.y + r * math.sin(a)
+			for rect in self.walls():
+				if inside(rect, px, py):
+					return int(4095 * (1 - d / 120.0))
+		return 0
+
+	#Infrared byte from the dock's buoys and force field
+	def infrared(self):
+		dock = self.world.get("dock")
+		if not dock:
+			return 255
+		dx, dy = self.x - dock[0], self.y - dock[1]
+		dist = math.hypot(dx, dy)
+		if dist > 2000:
+			return 255
+		bearing = math.degrees(angle_diff(math.atan2(dy, dx), math.radians(dock[2])))
+		if abs(bearing) > 60:
+			return 255
+		value = 240
+		if bearing >= -10:
+			value |= 8     #red buoy, left of the dock as seen from the robot
+		if bearing <= 10:
+			value |= 4     #green buoy
+		if dist < 600:
+			value |= 2     #force field
+		return value
+
+	def on_dock(self):
+		dock = self.world.get("dock")
+		if not dock:
+			return False
+		return math.hypot(self.x - dock[0], self.y - dock[1]) < BODY_RADIUS + 40 and \
+			abs(angle_diff(self.heading, math.radians(dock[2] + 180))) < math.radians(20)
+
+	def set_wheels(self, right, left):
+		self.right = float(clamp(right, -500, 500))
+		self.left = float(clamp(left, -500, 500))
+
+	#Advances the world by dt seconds
+	def step(self, dt):
+		self.sim_time += dt
+		signals = self.cliff_signals()
+		cliffs = [s == 0 for s in signals]
+		moving = self.right != 0 or self.left != 0
+
+		#Safe mode stops the motors and drops to passive on a cliff or wheel drop
+		if self.mode == MODE_SAFE and moving and (any(cliffs) or self.drops):
+			self.set_wheels(0, 0)
+			self.mode = MODE_PASSIVE
+			moving = False
+
+		dr, dl = self.right * dt, self.left * dt
+		if self.drops:
+			dr = dl = 0.0
+		d = (dr + dl) / 2
+		dtheta = (dr - dl) / WHEEL_BASE
+		if dtheta:
+			radius = d / dtheta
+			nx = self.x + radius * (math.sin(self.heading + dtheta) - math.sin(self.heading))
+			ny = self.y - radius * (math.cos(self.heading + dtheta) - math.cos(self.heading))
+		else:
+			nx = self.x + d * math.cos(self.heading)
+			ny = self.y + d * math.sin(self.heading)
+		nheading = self.heading + dtheta
+
+		#Moves that touch something are blocked, unless they move away from it
+		clearance = self.clearance(nx, ny)
+		if clearance >= 0 or clearance > self.clearance(self.x, self.y):
+			self.x, self.y, self.heading = nx, ny, nheading
+			self.distance += d
+			self.angle += math.degrees(dtheta)
+			self.bumps = 0
+			self.stalled = 0.0
+		else:
+			#The body is pushed against something; the wheels stall
+			self.bumps = self.contact(nx, ny, nheading)
+			if moving:
+				self.stalled += dt
+		self.overcurrents = 0x18 if self.stalled > 0.5 else 0
+
+		#The wheels drop when the middle of the robot is over a hole
+		self.drops = 0
+		for rect in self.world.get("cliffs", []):
+			if inside(rect, self.x, self.y):
+				self.drops = 0x1C
+				self.set_wheels(0, 0)
+
+		#Battery
+		if self.on_dock():
+			self.charging_sources = 2
+			self.current = CHARGE_CURRENT if self.charge < CAPACITY else 0
+			self.charging_state = 2 if self.charge < CAPACITY else 4
+		else:
+			self.charging_sources = 0
+			self.charging_state = 0
+			self.current = IDLE_CURRENT + MOTOR_CURRENT * (abs(self.right) + abs(self.left)) / 1000.0
+		self.charge = clamp(self.charge + self.current * dt / 3600.0 * self.drain_scale, 0, CAPACITY)
+
+	def voltage(self):
+		return int(12800 + 3000 * self.charge / CAPACITY + self.current * 0.4)
+
+	def song_playing(self):
+		return 1 if self.sim_time < self.song_end else 0
+
+	#Returns the value of one sensor packet; reading 19 and 20 clears them
+	def value(self, packet):
+		signals = self.cliff_signals()
+		if packet == 7:
+			return self.bumps | self.drops
+		if packet == 8:
+			return 1 if self.wall_signal() > 1000 else 0
+		if 9 <= packet <= 12:
+			return 1 if signals[packet - 9] == 0 else 0
+		if packet == 14:
+			return self.overcurrents
+		if packet == 17:
+			return self.infrared()
+		if packet == 19:
+			value = int(self.distance)
+			self.distance -= value
+			return value
+		if packet == 20:
+			value = int(self.angle)
+			self.angle -= value
+			return value
+		if packet == 21:
+			return self.charging_state
+		if packet == 22:
+			return self.voltage()
+		if packet == 23:
+			return int(self.current)
+		if packet == 24:
+			return int(25 + abs(self.current) / 200)
+		if packet == 25:
+			return int(self.charge)
+		if packet == 26:
+			return CAPACITY
+		if packet == 27:
+			return self.wall_signal()
+		if 28 <= packet <= 31:
+			return signals[packet - 28]
+		if packet == 34:
+			return self.charging_sources
+		if packet == 35:
+			return self.mode
+		if packet == 36:
+			return self.song_number
+		if packet == 37:
+			return self.song_playing()
+		if packet == 38:
+			return len(self.stream_ids) if self.streaming else 0
+		if 39 <= packet <= 42:
+			return self.requested[packet - 39]
+		return 0
+
+	#Packs a packet or group ID into the bytes the Create sends
+	def encode(self, packet):
+		if packet < len(GROUPS):
+			first, last = GROUPS[packet]
+			data = bytearray()
+			for p in range(first, last + 1):
+				data += self.encode(p)
+			return data
+		if packet not in PACKETS:
+			return bytearray()
+		size, signed = PACKETS[packet]
+		value = self.value(packet)
+		if size == 1:
+			return bytearray(struct.pack(">b" if signed else ">B", clamp(value, -128 if signed else 0, 127 if signed else 255)))
+		return bytearray(struct.pack(">h" if signed else ">H", clamp(value, -32768 if signed else 0, 32767 if signed else 65535)))
+
+	def stream_frame(self):
+		body = bytearray()
+		for packet in self.stream_ids:
+			body.append(packet)
+			body += self.encode(packet)
+		frame = bytearray([19, len(body)]) + body
+		frame.append(-sum(frame) & 0xFF)
+		return frame
+
+	#True when a wait-for-event condition holds (event IDs 1-22)
+	def event(self, number):
+		signals = self.cliff_signals()
+		cliffs = [s == 0 for s in signals]
+		table = {
+			1: self.drops != 0, 2: self.drops & 0x10, 3: self.drops & 0x08,
+			4: self.drops & 0x04, 5: self.bumps != 0, 6: self.bumps & 2,
+			7: self.bumps & 1, 8: False, 9: self.wall_signal() > 1000,
+			10: any(cliffs), 11: cliffs[0], 12: cliffs[1], 13: cliffs[2],
+			14: cliffs[3], 15: self.charging_sources & 2, 16: False,
+			17: False, 22: self.mode == MODE_PASSIVE,
+		}
+		return bool(table.get(number, False))
+
+
+#Splits a byte stream into complete commands
+def next_command(data):
+	"""Returns (command bytes, bytes used); command is None when more data is needed."""
+	if not data:
+		return None, 0
+	opcode = data[0]
+	if opcode not in ARGUMENTS:
+		return bytearray(), 1
+	length = ARGUMENTS[opcode]
+	if length is None:
+		if len(data) < 2:
+			return None, 0
+		if opcode == SONG:
+			if len(data) < 3:
+				return None, 0
+			length = 2 + 2 * data[2]
+		else:
+			length = 1 + data[1]
+	if len(data) < 1 + length:
+		return None, 0
+	return bytearray(data[:1 + length]), 1 + length
+
+
+#Runs the Create behind a pseudo-terminal
+class Emulator(object):
+	def __init__(self, create, args):
+		self.create = create
+		self.paced = args.timing == "paced"
+		self.latency = args.latency / 1000.0
+		self.scale = args.time_scale
+		self.strict_baud = args.strict_baud
+		self.verbose = args.verbose
+		self.master, self.slave = pty.openpty()
+		tty.setraw(self.slave)
+		self.path = os.ttyname(self.slave)
+		self.rx = bytearray()
+		self.replies = []     #(ready time, bytes, poll start or None)
+		self.out = bytearray()
+		self.marks = []       #(bytes left in self.out when a reply ends, poll start)
+		self.tx_clock = 0.0
+		self.wait = None      #wait condition of a running wait command
+		self.script_pc = None #next script byte while a script runs
+		self.script_abort = False
+		self.stats = {"rx_bytes": 0, "tx_bytes": 0, "commands": 0, "polls": 0,
+		              "stream_frames": 0, "stream_overruns": 0, "baud_mismatches": 0,
+		              "poll_latency_ms": []}
+		self.start = time.time()
+
+	def byte_time(self):
+		return 10.0 / self.create.baud / self.scale
+
+	#The baud rate the client set on its end of the pty, if it is a standard one
+	def client_baud(self):
+		speeds = {}
+		for rate in BAUD_RATES:
+			name = "B%d" % rate
+			if hasattr(termios, name):
+				speeds[getattr(termios, name)] = rate
+		try:
+			return speeds.get(termios.tcgetattr(self.slave)[5])
+		except termios.error:
+			return None
+
+	def baud_matches(self):
+		if not self.strict_baud:
+			return True
+		rate = self.client_baud()
+		return rate is None or rate == self.create.baud
+
+	def reply(self, data, poll):
+		ready = time.time() + (self.latency / self.scale if self.paced else 0)
+		self.replies.append((ready, data, time.time() if poll else None))
+
+	def log(self, text):
+		if self.verbose:
+			print("%8.3f %s" % (self.create.sim_time, text), file=sys.stderr)
+
+	#Carries out one complete command
+	def execute(self, command, from_script=False):
+		c = self.create
+		opcode = command[0]
+		self.stats["commands"] += 1
+		if c.mode == MODE_OFF and opcode != START:
+			return
+		driving = c.mode in (MODE_SAFE, MODE_FULL)
+
+		if opcode == START:
+			c.mode = MODE_PASSIVE
+			c.set_wheels(0, 0)
+		elif opcode == BAUD and command[1] < len(BAUD_RATES):
+			c.baud = BAUD_RATES[command[1]]
+			self.log("baud %d" % c.baud)
+		elif opcode in (CONTROL, SAFE):
+			c.mode = MODE_SAFE
+		elif opcode == FULL:
+			c.mode = MODE_FULL
+		elif opcode == POWER:
+			c.mode = MODE_PASSIVE
+			c.set_wheels(0, 0)
+		elif opcode in (SPOT, CLEAN, DEMO, FORCEDOCK):
+			c.mode = MODE_PASSIVE
+		elif opcode == DRIVE and driving:
+			velocity = clamp(signed16(command[1], command[2]), -500, 500)
+			radius = signed16(command[3], command[4])
+			if radius in (32767, -32768):
+				right = left = velocity
+			elif radius == 1:
+				right, left = velocity, -velocity
+			elif radius == -1:
+				right, left = -velocity, velocity
+			else:
+				radius = clamp(radius, -2000, 2000)
+				right = velocity * (radius + WHEEL_BASE / 2) / radius
+				left = velocity * (radius - WHEEL_BASE / 2) / radius
+			c.set_wheels(right, left)
+			c.requested = [velocity, radius, int(c.right), int(c.left)]
+		elif opcode == DRIVE_WHEELS and driving:
+			right = clamp(signed16(command[1], command[2]), -500, 500)
+			left = clamp(signed16(command[3], command[4]), -500, 500)
+			c.set_wheels(right, left)
+			c.requested = [(right + left) // 2, 0, right, left]
+		elif opcode == DRIVE_PWM and driving:
+			right = clamp(signed16(command[1], command[2]), -255, 255) * 500 // 255
+			left = clamp(signed16(command[3], command[4]), -255, 255) * 500 // 255
+			c.set_wheels(right, left)
+			c.requested = [(right + left) // 2, 0, right, left]
+		elif opcode == LEDS and driving:
+			c.leds = list(command[1:4])
+		elif opcode == SONG and command[1] < 16:
+			c.songs[command[1]] = command[3:]
+		elif opcode == PLAY and driving and command[1] in c.songs:
+			notes = c.songs[command[1]]
+			c.song_number = command[1]
+			c.song_end = c.sim_time + sum(notes[1::2]) / 64.0
+		elif opcode == SENSORS:
+			self.stats["polls"] += 1
+			self.reply(c.encode(command[1]), True)
+		elif opcode == QUERY_LIST:
+			self.stats["polls"] += 1
+			data = bytearray()
+			for packet in command[2:]:
+				data += c.encode(packet)
+			self.reply(data, True)
+		elif opcode == STREAM:
+			c.stream_ids = [p for p in command[2:] if p in PACKETS or p < len(GROUPS)]
+			c.streaming = bool(c.stream_ids)
+		elif opcode == DO_STREAM:
+			c.streaming = bool(command[1]) and bool(c.stream_ids)
+		elif opcode == SCRIPT:
+			c.script = bytearray(command[2:2 + SCRIPT_MAX])
+		elif opcode == PLAY_SCRIPT:
+			self.script_pc = 0
+			self.script_abort = False
+		elif opcode == SHOW_SCRIPT:
+			self.reply(bytearray([len(c.script)]) + c.script, False)
+		elif opcode == WAIT_TIME:
+			self.wait = ("time", c.sim_time + command[1] / 10.0)
+		elif opcode == WAIT_DISTANCE:
+			self.wait = ("distance", 0.0, signed16(command[1], command[2]))
+		elif opcode == WAIT_ANGLE:
+			self.wait = ("angle", 0.0, signed16(command[1], command[2]))
+		elif opcode == WAIT_EVENT:
+			event = struct.unpack("b", bytes(bytearray([command[1]])))[0]
+			self.wait = ("event", abs(event), event < 0)
+
+	#Advances a wait command; returns True when it is over
+	def wait_done(self, dt_distance, dt_angle):
+		kind = self.wait[0]
+		if kind == "time":
+			return self.create.sim_time >= self.wait[1]
+		if kind in ("distance", "angle"):
+			moved = self.wait[1] + (dt_distance if kind == "distance" else dt_angle)
+			self.wait = (kind, moved, self.wait[2])
+			target = self.wait[2]
+			return moved >= target if target >= 0 else moved <= target
+		return self.create.event(self.wait[1]) != self.wait[2]
+
+	#Runs script commands until the next wait or the end of the script
+	def run_script(self):
+		steps = 0
+		while self.script_pc is not None and self.wait is None and steps < SCRIPT_MAX:
+			if self.script_abort or self.script_pc >= len(self.create.script):
+				self.log("script %s" % ("aborted" if self.script_abort else "done"))
+				self.script_pc = None
+				return
+			command, used = next_command(self.create.script[self.script_pc:])
+			if command is None:
+				self.script_pc = None
+				return
+			self.script_pc += used
+			if command:
+				if command[0] == PLAY_SCRIPT:
+					self.script_pc = 0
+				else:
+					self.execute(command, True)
+			steps += 1
+
+	#Handles the bytes from the client that can be handled now
+	def handle_input(self):
+		while self.rx and self.wait is None:
+			command, used = next_command(self.rx)
+			if command is None:
+				return
+			del self.rx[:used]
+			if command:
+				self.execute(command)
+			self.run_script()
+
+	#Moves replies that are due to the output and writes what the line allows
+	def handle_output(self, now):
+		while self.replies and self.replies[0][0] <= now:
+			ready, data, poll = self.replies.pop(0)
+			if not self.out:
+				self.tx_clock = max(self.tx_clock, now)
+			self.out += data
+			if poll is not None:
+				self.marks.append((len(self.out), poll))
+		if not self.out:
+			return
+		if self.paced:
+			if now < self.tx_clock:
+				return
+			count = min(len(self.out), int((now - self.tx_clock) / self.byte_time()) + 1)
+		else:
+			count = len(self.out)
+		try:
+			written = os.write(self.master, bytes(self.out[:count]))
+		except OSError:
+			return
+		del self.out[:written]
+		self.tx_clock += written * self.byte_time()
+		self.stats["tx_bytes"] += written
+		marks = []
+		for end, poll in self.marks:
+			if end <= written:
+				self.stats["poll_latency_ms"].append((time.time() - poll) * 1000.0)
+			else:
+				marks.append((end - written, poll))
+		self.marks = marks
+
+	def sensor_tick(self, dt):
+		c = self.create
+		before_distance, before_angle = c.distance, c.angle
+		c.step(dt)
+		if self.wait is not None and self.wait_done(c.distance - before_distance, c.angle - before_angle):
+			self.wait = None
+			#Input that arrived during the wait ends the script
+			if self.rx and self.script_pc is not None:
+				self.script_abort = True
+			self.run_script()
+			self.handle_input()
+		if c.streaming:
+			frame = c.stream_frame()
+			#Frames that do not fit in 15 ms at the current rate get corrupted
+			if len(frame) * 10.0 / c.baud > SENSOR_PERIOD:
+				frame[-1] ^= 0xFF
+				self.stats["stream_overruns"] += 1
+			self.stats["stream_frames"] += 1
+			self.reply(frame, False)
+
+	def run(self, stop=None):
+		last_tick = time.time()
+		while stop is None or not stop.is_set():
+			now = time.time()
+			timeout = 0.001 if self.out or self.replies else SENSOR_PERIOD / self.scale / 3
+			ready = select.select([self.master], [], [], timeout)[0]
+			if ready:
+				try:
+					data = bytearray(os.read(self.master, 4096))
+				except OSError:
+					data = bytearray()
+				self.stats["rx_bytes"] += len(data)
+				if data and self.baud_matches():
+					self.rx += data
+					self.handle_input()
+				elif data:
+					self.stats["baud_mismatches"] += 1
+			now = time.time()
+			while now - last_tick >= SENSOR_PERIOD / self.scale:
+				last_tick += SENSOR_PERIOD / self.scale
+				self.sensor_tick(SENSOR_PERIOD)
+			if self.baud_matches():
+				self.handle_output(now)
+			else:
+				del self.out[:]
+
+	def summary(self):
+		elapsed = time.time() - self.start
+		latencies = sorted(self.stats["poll_latency_ms"])
+		result = dict(self.stats)
+		result["elapsed_s"] = round(elapsed, 3)
+		result["tx_bytes_per_s"] = round(self.stats["tx_bytes"] / elapsed, 1) if elapsed else 0
+		result["poll_latency_ms"] = {
+			"count": len(latencies),
+			"mean": round(sum(latencies) / len(latencies), 3) if latencies else 0,
+			"p95": round(latencies[int(len(latencies) * 0.95)], 3) if latencies else 0,
+			"max": round(latencies[-1], 3) if latencies else 0,
+		}
+		c = self.create
+		result["pose"] = [round(c.x), round(c.y), round(math.degrees(c.heading) % 360)]
+		result["baud"] = c.baud
+		result["charge"] = int(c.charge)
+		return result
+
+
+#Acts as the robot: switches to 115200, polls group 6, then streams
+def bench(path, polls, seconds):
+	fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+	tty.setraw(fd)
+
+	def send(data):
+		os.write(fd, bytes(bytearray(data)))
+
+	def read(count, timeout=0.5):
+		data = bytearray()
+		end = time.time() + timeout
+		while len(data) < count and time.time() < end:
+			if select.select([fd], [], [], 0.01)[0]:
+				data += bytearray(os.read(fd, count - len(data)))
+		return data
+
+	results = {}
+	send([START, BAUD, 11])
+	time.sleep(0.1)
+	send([FULL])
+	latencies = []
+	good = 0
+	for i in range(polls):
+		began = time.time()
+		send([SENSORS, 6])
+		if len(read(52)) == 52:
+			good += 1
+			latencies.append((time.time() - began) * 1000.0)
+	results["polls"] = polls
+	results["polls_good"] = good
+	results["poll_ms_mean"] = round(sum(latencies) / len(latencies), 3) if latencies else None
+
+	ids = [7, 9, 10, 11, 12, 19, 20, 28, 29, 30, 31, 41, 42]
+	send([DRIVE_WHEELS, 0, 100, 0, 100])
+	send([STREAM, len(ids)] + ids)
+	data = read(100000, seconds)
+	send([DO_STREAM, 0, DRIVE_WHEELS, 0, 0, 0, 0])
+	frames = bad = 0
+	i = 0
+	while i + 2 < len(data):
+		if data[i] != 19 or i + data[i + 1] + 2 >= len(data):
+			i += 1
+			continue
+		frame = data[i:i + data[i + 1] + 3]
+		if sum(frame) & 0xFF == 0:
+			frames += 1
+			i += len(frame)
+		else:
+			bad += 1
+			i += 1
+	results["stream_frames"] = frames
+	results["stream_bad"] = bad
+	results["stream_frames_per_s"] = round(frames / seconds, 1)
+	os.close(fd)
+	return results
+
+
+def load_world(path):
+	world = dict(DEFAULT_WORLD)
+	if path:
+		with open(path) as f:
+			world.update(json.load(f))
+	return world
+
+
+def main():
+	parser = argparse.ArgumentParser(description="iRobot Create emulator on a pseudo-terminal")
+	parser.add_argument("--link", help="also make this path a symlink to the pty")
+	parser.add_argument("--world", help="JSON file overriding parts of the default world")
+	parser.add_argument("--timing", choices=["ideal", "paced"], default="paced")
+	parser.add_argument("--latency", type=float, default=1.0, help="ms before a reply starts (paced)")
+	parser.add_argument("--time-scale", type=float, default=1.0, help="world speed relative to real time")
+	parser.add_argument("--strict-baud", action="store_true",
+	                    help="drop traffic while the client's baud rate differs from the Create's")
+	parser.add_argument("--charge", type=float, default=CAPACITY, help="starting charge in mAh")
+	parser.add_argument("--drain-scale", type=float, default=1.0, help="multiplies battery drain")
+	parser.add_argument("--noise", type=int, default=0, help="+/- noise on cliff signals")
+	parser.add_argument("--stats", help="write link statistics as JSON here on exit")
+	parser.add_argument("--bench", action="store_true", help="run a built-in client and print its results")
+	parser.add_argument("--verbose", action="store_true")
+	args = parser.parse_args()
+
+	create = Create(load_world(args.world), args.charge, args.drain_scale, args.noise)
+	emulator = Emulator(create, args)
+
+	if args.link:
+		if os.path.islink(args.link):
+			os.unlink(args.link)
+		os.symlink(emulator.path, args.link)
+	print("Create emulator on %s" % (args.link or emulator.path), file=sys.stderr)
+
+	stop = threading.Event()
+	signal.signal(signal.SIGINT, lambda *unused: stop.set())
+	signal.signal(signal.SIGTERM, lambda *unused: stop.set())
+	if args.bench:
+		thread = threading.Thread(target=emulator.run, args=(stop,))
+		thread.start()
+		try:
+			results = bench(emulator.path, 50, 2.0)
+		finally:
+			stop.set()
+			thread.join()
+		print(json.dumps(results, indent=1, sort_keys=True))
+	else:
+		emulator.run(stop)
+
+	summary = emulator.summary()
+	print(json.dumps(summary, indent=1, sort_keys=True), file=sys.stderr)
+	if args.stats:
+		with open(args.stats, "w") as f:
+			json.dump(summary, f, indent=1, sort_keys=True)
+	if args.link and os.path.islink(args.link):
+		os.unlink(args.link)
+
+
+if __name__ == "__main__":
+	main()
@@ -0,0 +1,135 @@
+/**
+*	@file	battery.c
+*	@brief	Battery governor: charge and draw estimate, speed cap, scan
+*			rationing and threshold warnings.
+*	@date	10/17/2026
+*/
+
+#include <stdio.h>
+#include "util.h"
+#include "drive.h"
+#include "battery.h"
+
+/// Charge thresholds by level; BATTERY_OK has none
+static const uint8_t battery_thresholds[] = {
+	100, BATTERY_LEVEL_LOW, BATTERY_LEVEL_CRITICAL, BATTERY_LEVEL_RESERVE
+};
+/// Shortest time between two scans by level
+static const uint16_t battery_scan_gaps[] = {
+	0, BATTERY_SCAN_GAP_LOW, BATTERY_SCAN_GAP_CRITICAL, BATTERY_SCAN_GAP_RESERVE
+};
+/// Warning text by level
+static const char *const battery_warnings[] = {
+	"Battery ok", "Battery low", "Battery critical", "Battery reserve, return now"
+};
+
+static battery_t battery = { 100, BATTERY_OK, 0, 0, 0, 0xFFFF, BATTERY_SPEED_FULL };
+/// clock_ms() of the last estimate and of the last scan
+static unsigned long battery_time;
+static unsigned long battery_scan_time;
+static uint8_t battery_started = 0;
+static uint8_t battery_scanned = 0;
+
+/**
+*	This method works out the level for a charge, with hysteresis on the way up
+*	@param	percent		Charge left in percent
+*	@return	BATTERY_OK .. BATTERY_RESERVE
+*	@date	10/17/2026
+*/
+static uint8_t battery_level(uint8_t percent)
+{
+	uint8_t level = BATTERY_OK;
+
+	while (level < BATTERY_RESERVE && percent <= battery_thresholds[level + 1])
+		level++;
+	/// Stay at the lower level until the charge is clearly above its threshold
+	while (level < battery.level && percent < battery_thresholds[level + 1] + BATTERY_HYSTERESIS)
+		level++;
+	return level;
+}
+
+/**
+*	This method folds new sensor data into the estimate
+*	@param	sensor		Sensor data with the battery fields
+*	@date	10/17/2026
+*/
+void battery_update(const oi_t *sensor)
+{
+	char output[40];
+	uint8_t level;
+	int16_t draw;
+
+	if (battery_started && clock_ms() - battery_time < BATTERY_PERIOD_MS)
+		return;
+	battery_time = clock_ms();
+
+	/// First reading as is, then a moving average over about 8 seconds
+	if (!battery_started)
+	{
+		battery.voltage = sensor->voltage;
+		battery.current = sensor->current;
+		battery_started = 1;
+	}
+	else
+	{
+		battery.voltage += ((int16_t) (sensor->voltage - battery.voltage)) / 8;
+		battery.current += (sensor->current - battery.current) / 8;
+	}
+
+	if (sensor->capacity != 0)
+		battery.percent = sensor->charge >= sensor->capacity ? 100
+			: (uint8_t) ((uint32_t) sensor->charge * 100 / sensor->capacity);
+	battery.energy = (uint16_t) ((uint32_t) sensor->charge * battery.voltage / 1000);
+
+	draw = -battery.current;
+	battery.minutes = draw > 0 ? (uint16_t) ((uint32_t) sensor->charge * 60 / draw) : 0xFFFF;
+
+	level = battery_level(battery.percent);
+	/// A sagging pack is nearly empty even if the charge count disagrees
+	if (battery.voltage != 0 && battery.voltage < BATTERY_VOLTAGE_RESERVE)
+		level = BATTERY_RESERVE;
+
+	/// Full speed down to the low threshold, then less and less
+	if (battery.percent >= BATTERY_LEVEL_LOW)
+		battery.speed_cap = BATTERY_SPEED_FULL;
+	else if (battery.percent <= BATTERY_LEVEL_RESERVE)
+		battery.speed_cap = BATTERY_SPEED_RESERVE;
+	else
+		battery.speed_cap = BATTERY_SPEED_RESERVE + (uint16_t) (BATTERY_SPEED_FULL - BATTERY_SPEED_RESERVE)
+			* (battery.percent - BATTERY_LEVEL_RESERVE) / (BATTERY_LEVEL_LOW - BATTERY_LEVEL_RESERVE);
+	if (level == BATTERY_RESERVE)
+		battery.speed_cap = BATTERY_SPEED_RESERVE;
+	drive_set_speed_limit(battery.speed_cap);
+
+	/// Warn once per threshold crossed on the way down
+	if (level > battery.level)
+	{
+		sprintf(output, "W,%s %u%%", battery_warnings[level], battery.percent);
+		serial_puts(output);
+	}
+	battery.level = level;
+}
+
+/**
+*	This method returns the current estimate
+*	@return	battery estimate
+*	@date	10/17/2026
+*/
+const battery_t *battery_state(void)
+{
+	return &battery;
+}
+
+/**
+*	This method rations scans by battery level
+*	@return	1 if a scan may run now
+*	@date	10/17/2026
+*/
+uint8_t battery_scan_allowed(void)
+{
+	if (battery_scanned && clock_ms() - battery_scan_time < battery_scan_gaps[battery.level])
+		return 0;
+	battery_scan_time = clock_ms();
+	battery_scanned = 1;
+	return 1;
+}
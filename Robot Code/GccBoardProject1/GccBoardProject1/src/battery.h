@@ -0,0 +1,68 @@
+/**
+*	@file	battery.h
+*	@brief	Battery governor. Estimates the charge left and the current draw
+*			from the Create's battery packets, caps the wheel speed and rations
+*			scans as the charge drops, and warns the host at each threshold.
+*	@date	10/17/2026
+*/
+
+#ifndef BATTERY_H
+#define BATTERY_H
+
+#include <inttypes.h>
+#include "open_interface.h"
+
+/// Charge thresholds in percent of capacity
+#define BATTERY_LEVEL_LOW		40	// speed starts to be capped, scans rationed
+#define BATTERY_LEVEL_CRITICAL	20
+#define BATTERY_LEVEL_RESERVE	10	// only enough left to get back
+/// A threshold is warned about again only after the charge rose this far above it
+#define BATTERY_HYSTERESIS		3
+/// Pack voltage (mV) under which the battery counts as in reserve, whatever
+/// the charge reading says
+#define BATTERY_VOLTAGE_RESERVE	12000
+
+/// Speed cap (mm/s) at BATTERY_LEVEL_LOW and above, and at BATTERY_LEVEL_RESERVE
+/// and below; linear in between
+#define BATTERY_SPEED_FULL		500
+#define BATTERY_SPEED_RESERVE	100
+
+/// Shortest time between two scans (ms) at each level
+#define BATTERY_SCAN_GAP_LOW		5000
+#define BATTERY_SCAN_GAP_CRITICAL	15000
+#define BATTERY_SCAN_GAP_RESERVE	30000
+
+/// The estimate is refreshed at most this often (ms)
+#define BATTERY_PERIOD_MS 1000
+
+/// Battery levels, from battery_state()->level
+#define BATTERY_OK			0
+#define BATTERY_LOW			1
+#define BATTERY_CRITICAL	2
+#define BATTERY_RESERVE		3
+
+/// What the governor knows about the battery
+typedef struct {
+	uint8_t percent;		// charge left in percent of capacity
+	uint8_t level;			// BATTERY_OK .. BATTERY_RESERVE
+	uint16_t voltage;		// mV, filtered
+	int16_t current;		// mA, filtered; negative while discharging
+	uint16_t energy;		// mWh left
+	uint16_t minutes;		// at the current draw; 0xFFFF while charging or idle
+	uint16_t speed_cap;		// mm/s
+} battery_t;
+
+/// \brief Fold new sensor data into the estimate, at most once per
+/// BATTERY_PERIOD_MS. Applies the speed cap and warns the host ("W,...")
+/// when a threshold is crossed.
+/// \param sensor sensor data with voltage, current, charge and capacity
+void battery_update(const oi_t *sensor);
+
+/// \return the current estimate
+const battery_t *battery_state(void);
+
+/// \brief Ask whether a scan may run now; rations scans as the charge drops.
+/// \return 1 if it may, in which case the scan is counted as started
+uint8_t battery_scan_allowed(void);
+
+#endif
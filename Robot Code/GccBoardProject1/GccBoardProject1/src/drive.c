@@ -0,0 +1,549 @@
+/**
+*	@file	drive.c
+*	@brief	S-curve wheel speed profiles in Q8 fixed point. Each wheel
+*			follows its target with bounded acceleration and jerk.
+*	@date	10/17/2026
+*/
+
+#include <stdlib.h>
+#include "util.h"
+#include "open_interface.h"
+#include "drive.h"
+
+/// Profile state of one wheel
+typedef struct {
+	int16_t target;		// mm/s
+	int32_t speed;		// mm/s in Q8
+	int32_t accel;		// mm/s^2 in Q8
+} drive_wheel_t;
+
+/// Right and left wheel
+static drive_wheel_t drive_wheels[2];
+static uint16_t drive_accel = DRIVE_ACCEL_DEFAULT;
+static uint16_t drive_jerk = DRIVE_JERK_DEFAULT;
+/// Largest wheel speed in mm/s
+static uint16_t drive_limit = 500;
+/// clock_ms() of the last tick
+static unsigned long drive_time;
+/// Set while a wheel is not at its target
+static uint8_t drive_moving = 0;
+
+static uint8_t drive_mode = DRIVE_MODE_VELOCITY;
+/// PWM loop: gains, accumulated error (mm/s * ms) and whether it is running
+static uint16_t drive_kp = DRIVE_PWM_KP_DEFAULT;
+static uint16_t drive_ki = DRIVE_PWM_KI_DEFAULT;
+static int32_t drive_integral[2];
+static uint8_t drive_pwm_running = 0;
+
+/// Measured wheel speeds (mm/s), and the last few frames they are taken
+/// over; one frame moves in steps of 1 mm and 1 degree, too coarse alone
+#define DRIVE_WINDOW 4
+static int16_t drive_speed_measured[2];
+static uint16_t drive_seq;
+static int16_t drive_distance_sums[DRIVE_WINDOW];
+static int16_t drive_angle_sums[DRIVE_WINDOW];
+static unsigned long drive_frame_times[DRIVE_WINDOW];
+static uint8_t drive_frame_next = 0;
+static uint8_t drive_frames = 0;
+
+/**
+*	This method returns the integer square root
+*	@param	value	Number to take the root of
+*	@return	largest root whose square is at most value
+*	@date	10/17/2026
+*/
+static uint16_t drive_sqrt(uint32_t value)
+{
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > value)
+		bit >>= 2;
+	while (bit != 0)
+	{
+		if (value >= root + bit)
+		{
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+			root >>= 1;
+		bit >>= 2;
+	}
+	return (uint16_t) root;
+}
+
+/**
+*	This method advances one wheel by one tick
+*	@param	wheel	Wheel to advance
+*	@return	1 if the wheel is at its target
+*	@date	10/17/2026
+*/
+static uint8_t drive_step(drive_wheel_t *wheel)
+{
+	int32_t target = (int32_t) wheel->target << DRIVE_Q;
+	int32_t error = target - wheel->speed;
+	int32_t limit, step, want;
+
+	/// Less than 1 mm/s to go, or no ramps at all
+	if (labs(error) < (1L << DRIVE_Q) || drive_accel == 0)
+	{
+		wheel->speed = target;
+		wheel->accel = 0;
+		return 1;
+	}
+
+	/// Aim for full acceleration, but no more than can be taken back to 0
+	/// with the jerk limit before the target is reached: a^2 = 2 j |error|
+	limit = (int32_t) drive_accel << DRIVE_Q;
+	if (drive_jerk != 0)
+	{
+		want = (int32_t) drive_sqrt(2UL * drive_jerk * (labs(error) >> DRIVE_Q)) << DRIVE_Q;
+		if (want < limit)
+			limit = want;
+	}
+	want = error > 0 ? limit : -limit;
+
+	/// Change the acceleration by at most one tick of jerk
+	if (drive_jerk == 0)
+		wheel->accel = want;
+	else
+	{
+		step = ((int32_t) drive_jerk << DRIVE_Q) * DRIVE_TICK_MS / 1000;
+		if (want > wheel->accel + step)
+			wheel->accel += step;
+		else if (want < wheel->accel - step)
+			wheel->accel -= step;
+		else
+			wheel->accel = want;
+	}
+
+	/// Arrive exactly instead of overshooting
+	step = wheel->accel * DRIVE_TICK_MS / 1000;
+	if ((error > 0 && step >= error) || (error < 0 && step <= error))
+	{
+		wheel->speed = target;
+		wheel->accel = 0;
+		return 1;
+	}
+	wheel->speed += step;
+	return 0;
+}
+
+/**
+*	This method works out the wheel speeds from each new sensor frame
+*	@date	10/17/2026
+*/
+static void drive_measure(void)
+{
+	oi_frame_t frame;
+	int16_t distance, turn;
+	unsigned long elapsed;
+	uint8_t oldest;
+
+	if (drive_frames && oi_frame_seq() == drive_seq)
+		return;
+	drive_seq = oi_frame_copy(&frame);
+
+	/// A long gap says nothing about the current speed; start over
+	if (drive_frames && frame.time_ms - drive_frame_times[(drive_frame_next + DRIVE_WINDOW - 1) % DRIVE_WINDOW] > 200)
+	{
+		drive_frames = 0;
+		drive_speed_measured[0] = 0;
+		drive_speed_measured[1] = 0;
+	}
+	oldest = drive_frames < DRIVE_WINDOW ? 0 : drive_frame_next;
+	distance = frame.distance_sum - drive_distance_sums[oldest];
+	/// Each wheel is half the wheel base from the center: 2.25 mm per degree (576 / 256)
+	turn = (int16_t) (((int32_t) (int16_t) (frame.angle_sum - drive_angle_sums[oldest]) * 576) >> 8);
+	elapsed = frame.time_ms - drive_frame_times[oldest];
+	if (drive_frames && elapsed != 0)
+	{
+		drive_speed_measured[0] = (int16_t) ((int32_t) (distance + turn) * 1000 / (long) elapsed);
+		drive_speed_measured[1] = (int16_t) ((int32_t) (distance - turn) * 1000 / (long) elapsed);
+	}
+
+	drive_distance_sums[drive_frame_next] = frame.distance_sum;
+	drive_angle_sums[drive_frame_next] = frame.angle_sum;
+	drive_frame_times[drive_frame_next] = frame.time_ms;
+	drive_frame_next = (drive_frame_next + 1) % DRIVE_WINDOW;
+	if (drive_frames < DRIVE_WINDOW)
+		drive_frames++;
+}
+
+/**
+*	This method runs one step of the PWM speed loop
+*	@date	10/17/2026
+*/
+static void drive_pwm_step(void)
+{
+	int16_t pwm[2];
+	int32_t setpoint, error, limit;
+	uint8_t i;
+
+	drive_pwm_running = 0;
+	/// Largest accumulated error, so the integral term stays within +-128
+	limit = drive_ki ? (128L << DRIVE_Q) * 1000 / drive_ki : 0;
+	for (i = 0; i < 2; i++)
+	{
+		setpoint = drive_wheels[i].speed >> DRIVE_Q;
+		if (setpoint == 0 && drive_wheels[i].target == 0)
+		{
+			drive_integral[i] = 0;
+			pwm[i] = 0;
+			continue;
+		}
+		drive_pwm_running = 1;
+		error = setpoint - drive_speed_measured[i];
+		drive_integral[i] += error * DRIVE_TICK_MS;
+		if (drive_integral[i] > limit)
+			drive_integral[i] = limit;
+		if (drive_integral[i] < -limit)
+			drive_integral[i] = -limit;
+		pwm[i] = (int16_t) ((setpoint * DRIVE_PWM_FEEDFORWARD + error * drive_kp
+			+ drive_integral[i] * drive_ki / 1000) >> DRIVE_Q);
+	}
+	oi_set_wheels_pwm(pwm[0], pwm[1]);
+}
+
+/**
+*	This method sends the current setpoints
+*	@date	10/17/2026
+*/
+static void drive_send(void)
+{
+	if (drive_mode == DRIVE_MODE_PWM)
+		drive_pwm_step();
+	else
+		oi_set_wheels((int16_t) (drive_wheels[0].speed >> DRIVE_Q), (int16_t) (drive_wheels[1].speed >> DRIVE_Q));
+}
+
+/**
+*	This method stores new targets, scaled down together to the speed limit
+*	@param	right_wheel		Target speed of the right wheel in mm/s
+*	@param	left_wheel		Target speed of the left wheel in mm/s
+*	@date	10/17/2026
+*/
+static void drive_target(int16_t right_wheel, int16_t left_wheel)
+{
+	uint16_t fastest = abs(right_wheel) > abs(left_wheel) ? abs(right_wheel) : abs(left_wheel);
+
+	if (fastest > drive_limit)
+	{
+		right_wheel = (int16_t) ((int32_t) right_wheel * drive_limit / fastest);
+		left_wheel = (int16_t) ((int32_t) left_wheel * drive_limit / fastest);
+	}
+	drive_wheels[0].target = right_wheel;
+	drive_wheels[1].target = left_wheel;
+}
+
+/**
+*	This method ramps the wheels toward new speeds
+*	@param	right_wheel		Target speed of the right wheel in mm/s
+*	@param	left_wheel		Target speed of the left wheel in mm/s
+*	@date	10/17/2026
+*/
+void drive_set(int16_t right_wheel, int16_t left_wheel)
+{
+	drive_target(right_wheel, left_wheel);
+	/// Start ticking from now, not from the last time the robot moved
+	if (!drive_moving && !drive_pwm_running)
+		drive_time = clock_ms() - DRIVE_TICK_MS;
+	drive_moving = 1;
+	drive_service();
+}
+
+/**
+*	This method sets the wheel speeds without a ramp
+*	@param	right_wheel		Speed of the right wheel in mm/s
+*	@param	left_wheel		Speed of the left wheel in mm/s
+*	@date	10/17/2026
+*/
+void drive_set_now(int16_t right_wheel, int16_t left_wheel)
+{
+	drive_target(right_wheel, left_wheel);
+	drive_wheels[0].speed = (int32_t) drive_wheels[0].target << DRIVE_Q;
+	drive_wheels[0].accel = 0;
+	drive_wheels[1].speed = (int32_t) drive_wheels[1].target << DRIVE_Q;
+	drive_wheels[1].accel = 0;
+	drive_moving = 0;
+	/// Hazards go through the Create's velocity control, which also ends PWM
+	drive_integral[0] = 0;
+	drive_integral[1] = 0;
+	drive_pwm_running = 0;
+	oi_set_wheels(drive_wheels[0].target, drive_wheels[1].target);
+	oi_wheels_flush();
+}
+
+/**
+*	This method takes over wheel speeds set by another command
+*	@param	right_wheel		Speed of the right wheel in mm/s
+*	@param	left_wheel		Speed of the left wheel in mm/s
+*	@date	10/17/2026
+*/
+void drive_assume(int16_t right_wheel, int16_t left_wheel)
+{
+	drive_wheels[0].target = right_wheel;
+	drive_wheels[0].speed = (int32_t) right_wheel << DRIVE_Q;
+	drive_wheels[0].accel = 0;
+	drive_wheels[1].target = left_wheel;
+	drive_wheels[1].speed = (int32_t) left_wheel << DRIVE_Q;
+	drive_wheels[1].accel = 0;
+	drive_moving = 0;
+	drive_integral[0] = 0;
+	drive_integral[1] = 0;
+	drive_pwm_running = 0;
+}
+
+/**
+*	This method caps the speed of both wheels
+*	@param	limit	Largest wheel speed in mm/s
+*	@date	10/17/2026
+*/
+void drive_set_speed_limit(uint16_t limit)
+{
+	if (limit == drive_limit)
+		return;
+	drive_limit = limit;
+	/// Slow down a motion that is already running
+	if (abs(drive_wheels[0].target) > limit || abs(drive_wheels[1].target) > limit)
+		drive_set(drive_wheels[0].target, drive_wheels[1].target);
+}
+
+/**
+*	This method clamps a speed to the speed limit
+*	@param	speed	Wheel speed in mm/s
+*	@return	speed, no faster than the limit
+*	@date	10/17/2026
+*/
+int16_t drive_clamp(int16_t speed)
+{
+	if (speed > (int16_t) drive_limit)
+		return drive_limit;
+	if (speed < -(int16_t) drive_limit)
+		return -drive_limit;
+	return speed;
+}
+
+/**
+*	This method sets the profile limits
+*	@param	accel	Largest acceleration in mm/s^2, 0 for no ramps
+*	@param	jerk	Largest jerk in mm/s^3, 0 for no jerk limit
+*	@date	10/17/2026
+*/
+void drive_set_limits(uint16_t accel, uint16_t jerk)
+{
+	drive_accel = accel;
+	drive_jerk = jerk;
+}
+
+/**
+*	This method advances the profile by the ticks that passed
+*	@date	10/17/2026
+*/
+void drive_service(void)
+{
+	uint8_t ticks = 0;
+	uint8_t done = 1;
+
+	drive_measure();
+	if (!drive_moving && !drive_pwm_running)
+		return;
+
+	/// Catch up on at most a few ticks after a long blocking call
+	while (clock_ms() - drive_time >= DRIVE_TICK_MS && ticks < 4)
+	{
+		drive_time += DRIVE_TICK_MS;
+		if (drive_moving)
+			done = drive_step(&drive_wheels[0]) & drive_step(&drive_wheels[1]);
+		ticks++;
+	}
+	if (ticks == 0)
+		return;
+	if (clock_ms() - drive_time >= DRIVE_TICK_MS)
+		drive_time = clock_ms();
+
+	drive_send();
+	if (done)
+		drive_moving = 0;
+}
+
+/**
+*	This method chooses how setpoints reach the wheels
+*	@param	mode	DRIVE_MODE_VELOCITY or DRIVE_MODE_PWM
+*	@date	10/17/2026
+*/
+void drive_set_mode(uint8_t mode)
+{
+	if (mode == drive_mode)
+		return;
+	drive_set_now(0, 0);
+	drive_mode = mode;
+}
+
+/**
+*	This method sets the PWM loop gains
+*	@param	kp		Duty per mm/s of error, Q8
+*	@param	ki		Duty per mm of accumulated error, Q8
+*	@date	10/17/2026
+*/
+void drive_set_pwm_gains(uint16_t kp, uint16_t ki)
+{
+	drive_kp = kp;
+	drive_ki = ki;
+}
+
+/**
+*	This method returns the measured wheel speeds
+*	@param	right	Where to store the right wheel speed in mm/s
+*	@param	left	Where to store the left wheel speed in mm/s
+*	@date	10/17/2026
+*/
+void drive_measured(int16_t *right, int16_t *left)
+{
+	*right = drive_speed_measured[0];
+	*left = drive_speed_measured[1];
+}
+
+/**
+*	This method times the response to a speed step
+*	@param	sensor	Sensor struct, updated while the step runs
+*	@param	speed	Step size in mm/s
+*	@param	mode	DRIVE_MODE_VELOCITY or DRIVE_MODE_PWM
+*	@param	result	Where to store the timings
+*	@date	10/17/2026
+*/
+void drive_step_response(oi_t *sensor, int16_t speed, uint8_t mode, drive_step_t *result)
+{
+	uint16_t accel = drive_accel;
+	uint16_t jerk = drive_jerk;
+	uint8_t old_mode = drive_mode;
+	unsigned long start, elapsed;
+	int16_t measured;
+	int16_t step = abs(speed);
+
+	result->mode = mode;
+	result->speed = speed;
+	result->first_ms = 0;
+	result->rise_ms = 0;
+	result->peak = 0;
+
+	drive_set_mode(mode);
+	drive_set_limits(0, 0);
+	start = clock_ms();
+	drive_set(speed, speed);
+	while ((elapsed = clock_ms() - start) < 1500)
+	{
+		oi_update(sensor);
+		measured = (drive_speed_measured[0] + drive_speed_measured[1]) / 2;
+		if (speed < 0)
+			measured = -measured;
+		if (measured > result->peak)
+			result->peak = measured;
+		if (result->first_ms == 0 && measured >= step / 10)
+			result->first_ms = elapsed;
+		if (result->rise_ms == 0 && measured >= step - step / 10)
+			result->rise_ms = elapsed;
+	}
+	if (speed < 0)
+		result->peak = -result->peak;
+
+	drive_set_now(0, 0);
+	drive_set_limits(accel, jerk);
+	drive_set_mode(old_mode);
+}
+
+/**
+*	This method tells whether the wheels reached their targets
+*	@return	1 once both wheels run at their target speeds
+*	@date	10/17/2026
+*/
+uint8_t drive_idle(void)
+{
+	return !drive_moving;
+}
+
+/**
+*	This method returns the current setpoint of the faster wheel
+*	@return	mm/s, never negative
+*	@date	10/17/2026
+*/
+int16_t drive_speed(void)
+{
+	int32_t speed = labs(drive_wheels[0].speed);
+
+	if (labs(drive_wheels[1].speed) > speed)
+		speed = labs(drive_wheels[1].speed);
+	return (int16_t) (speed >> DRIVE_Q);
+}
+
+/**
+*	This method returns the current setpoints
+*	@param	right	Where to store the right wheel setpoint in mm/s
+*	@param	left	Where to store the left wheel setpoint in mm/s
+*	@date	10/17/2026
+*/
+void drive_setpoints(int16_t *right, int16_t *left)
+{
+	*right = (int16_t) (drive_wheels[0].speed >> DRIVE_Q);
+	*left = (int16_t) (drive_wheels[1].speed >> DRIVE_Q);
+}
+
+/**
+*	This method returns the targets the wheels ramp toward
+*	@param	right	Where to store the right wheel target in mm/s
+*	@param	left	Where to store the left wheel target in mm/s
+*	@date 10/17/2026
+*/
+void drive_targets(int16_t *right, int16_t *left)
+{
+	*right = drive_wheels[0].target;
+	*left = drive_wheels[1].target;
+}
+
+/**
+*	This method estimates the distance needed to stop
+*	@return	mm the faster wheel travels from its setpoint to 0
+*	@date	10/17/2026
+*/
+int16_t drive_stop_distance(void)
+{
+	int32_t speed = labs(drive_wheels[0].speed);
+	uint32_t v, t_ms;
+
+	if (labs(drive_wheels[1].speed) > speed)
+		speed = labs(drive_wheels[1].speed);
+	v = speed >> DRIVE_Q;
+	if (drive_accel == 0 || v == 0)
+		return 0;
+
+	/// The S-curve is symmetric, so the average speed is v / 2. It takes
+	/// v / a + a / j, or 2 sqrt(v / j) when full acceleration is never reached.
+	if (drive_jerk == 0)
+		t_ms = v * 1000 / drive_accel;
+	else if (v * drive_jerk >= (uint32_t) drive_accel * drive_accel)
+		t_ms = v * 1000 / drive_accel + (uint32_t) drive_accel * 1000 / drive_jerk;
+	else
+		t_ms = 2UL * drive_sqrt(v * 1000000UL / drive_jerk);
+	return (int16_t) (v * t_ms / 2000);
+}
+
+/**
+*	This method finds the speed that still stops in a given distance
+*	@param	distance	mm left to go
+*	@return	mm/s; the inverse of drive_stop_distance()
+*	@date	10/17/2026
+*/
+int16_t drive_approach_speed(int16_t distance)
+{
+	uint32_t b;
+
+	if (distance <= 0)
+		return 0;
+	if (drive_accel == 0)
+		return 500;
+	/// d = v * a / j + v / 2 * (v / a + a / j) solved for v, with b = 3 a^2 / j.
+	/// The first term is the time to take back an acceleration still running.
+	b = drive_jerk ? 3UL * drive_accel * drive_accel / drive_jerk : 0;
+	return (int16_t) ((drive_sqrt(b * b + 8UL * drive_accel * (uint32_t) distance) - b) / 2);
+}
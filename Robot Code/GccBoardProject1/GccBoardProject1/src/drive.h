@@ -0,0 +1,123 @@
+/**
+*	@file	drive.h
+*	@brief	Acceleration and jerk limited wheel speed profiles. Callers set a
+*			target speed for each wheel and the setpoints sent to the Create
+*			ramp toward it on a periodic tick.
+*	@date	10/17/2026
+*/
+
+#ifndef DRIVE_H
+#define DRIVE_H
+
+#include <inttypes.h>
+#include "open_interface.h"
+
+/// Fractional bits of the profile's speeds and accelerations (Q8)
+#define DRIVE_Q 8
+/// Profile tick in ms; one step per Create command period
+#define DRIVE_TICK_MS 15
+/// Default limits: 0 to 250 mm/s in about 0.6 s
+#define DRIVE_ACCEL_DEFAULT 500		// mm/s^2
+#define DRIVE_JERK_DEFAULT 2500		// mm/s^3
+
+/// How the setpoints reach the wheels
+#define DRIVE_MODE_VELOCITY	0	// the Create's own velocity control (opcode 145)
+#define DRIVE_MODE_PWM		1	// a PI loop here, through raw PWM (opcode 146)
+/// PWM loop gains in Q8: duty per mm/s of setpoint, per mm/s of error and
+/// per mm of accumulated error. Full duty (255) is about 500 mm/s.
+#define DRIVE_PWM_FEEDFORWARD	131
+#define DRIVE_PWM_KP_DEFAULT	77
+#define DRIVE_PWM_KI_DEFAULT	256
+
+/// Result of drive_step_response()
+typedef struct {
+	uint8_t mode;			// DRIVE_MODE_VELOCITY or DRIVE_MODE_PWM
+	int16_t speed;			// step size in mm/s
+	uint16_t first_ms;		// until the measured speed reached 10% of the step
+	uint16_t rise_ms;		// until it reached 90%; 0 if it never did
+	int16_t peak;			// highest measured speed in mm/s
+} drive_step_t;
+
+/// \brief Ramp the wheels toward new speeds
+/// \param right_wheel target speed of the right wheel in mm/s
+/// \param left_wheel target speed of the left wheel in mm/s
+void drive_set(int16_t right_wheel, int16_t left_wheel);
+
+/// \brief Set the wheel speeds at once, without a ramp. For hazards, and to
+/// tell the profile about speeds set some other way (scripts, mode changes).
+/// \param right_wheel speed of the right wheel in mm/s
+/// \param left_wheel speed of the left wheel in mm/s
+void drive_set_now(int16_t right_wheel, int16_t left_wheel);
+
+/// \brief Take over wheel speeds set by another command (the radius drive,
+/// scripts) so later ramps start from them. Sends nothing.
+/// \param right_wheel speed of the right wheel in mm/s
+/// \param left_wheel speed of the left wheel in mm/s
+void drive_assume(int16_t right_wheel, int16_t left_wheel);
+
+/// \brief Cap the speed of both wheels, e.g. to save the battery. Targets
+/// above it are scaled down together so the robot keeps its path.
+/// \param limit largest wheel speed in mm/s
+void drive_set_speed_limit(uint16_t limit);
+
+/// \return speed clamped to the limit set with drive_set_speed_limit()
+int16_t drive_clamp(int16_t speed);
+
+/// \brief Set the profile limits
+/// \param accel largest acceleration in mm/s^2; 0 turns the ramps off
+/// \param jerk largest change of acceleration in mm/s^3; 0 allows steps
+void drive_set_limits(uint16_t accel, uint16_t jerk);
+
+/// \brief Choose how setpoints reach the wheels. Stops the robot when the mode
+/// changes. PWM mode reacts faster at low speeds but relies on the measured
+/// wheel speeds, so the distance and angle packets must be streamed or polled.
+/// \param mode DRIVE_MODE_VELOCITY or DRIVE_MODE_PWM
+void drive_set_mode(uint8_t mode);
+
+/// \brief Set the PWM loop gains
+/// \param kp duty per mm/s of error, Q8
+/// \param ki duty per mm of accumulated error, Q8
+void drive_set_pwm_gains(uint16_t kp, uint16_t ki);
+
+/// \brief Wheel speeds measured from the distance and angle of recent frames
+/// \param right where to store the right wheel speed in mm/s
+/// \param left where to store the left wheel speed in mm/s
+void drive_measured(int16_t *right, int16_t *left);
+
+/// \brief Benchmark: step both wheels from rest to speed with no ramp, time
+/// the measured response for 1.5 s, then stop. Blocks; the robot moves.
+/// \param sensor sensor struct, updated while the step runs
+/// \param speed step size in mm/s
+/// \param mode DRIVE_MODE_VELOCITY or DRIVE_MODE_PWM
+/// \param result where to store the timings
+void drive_step_response(oi_t *sensor, int16_t speed, uint8_t mode, drive_step_t *result);
+
+/// Advance the profile by the ticks that passed and send the new setpoints.
+/// Called by oi_update() and oi_update_list(); loops that wait without
+/// them must call it themselves.
+void drive_service(void);
+
+/// \return 1 once both wheels run at their target speeds
+uint8_t drive_idle(void);
+
+/// \return setpoint of the faster wheel in mm/s, never negative
+int16_t drive_speed(void);
+
+/// \brief The setpoints the profile sends now, on the way to the targets
+/// \param right where to store the right wheel setpoint in mm/s
+/// \param left where to store the left wheel setpoint in mm/s
+void drive_setpoints(int16_t *right, int16_t *left);
+
+/// \brief The targets the profile ramps toward
+/// \param right where to store the right wheel target in mm/s
+/// \param left where to store the left wheel target in mm/s
+void drive_targets(int16_t *right, int16_t *left);
+
+/// \return mm the faster wheel still travels if told to stop now
+int16_t drive_stop_distance(void);
+
+/// \return the highest speed in mm/s from which the profile still stops
+/// within distance mm, even if it is still accelerating
+int16_t drive_approach_speed(int16_t distance);
+
+#endif
@@ -0,0 +1,219 @@
+/**
+*	@file	grid.c
+*	@brief	Occupancy grid of the arena in 2 bits per cell.
+*	@date	10/17/2026
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "odometry.h"
+#include "grid.h"
+
+/// Cells 4 to a byte, row by row; all unknown to start with
+static uint8_t grid_cells[GRID_SIZE * GRID_ROW_BYTES];
+/// Corner of cell (0, 0) in the odometry frame; the start is in the middle
+static int16_t grid_origin_x = -(GRID_SIZE / 2) * GRID_CELL;
+static int16_t grid_origin_y = -(GRID_SIZE / 2) * GRID_CELL;
+/// Bumped each time a cell starts to block, see grid_changes()
+static uint8_t grid_changed = 0;
+
+/**
+*	This method forgets everything and places the grid
+*	@param	origin_x_mm		x of the corner of cell (0, 0)
+*	@param	origin_y_mm		y of the corner of cell (0, 0)
+*	@date	10/17/2026
+*/
+void grid_clear(int16_t origin_x_mm, int16_t origin_y_mm)
+{
+	memset(grid_cells, 0, sizeof(grid_cells));
+	grid_origin_x = origin_x_mm;
+	grid_origin_y = origin_y_mm;
+	grid_changed++;
+}
+
+/**
+*	This method counts the changes that can block a way
+*	@return	the count, wrapping at 256
+*	@date	10/17/2026
+*/
+uint8_t grid_changes(void)
+{
+	return grid_changed;
+}
+
+/**
+*	This method returns where the grid is
+*	@param	x_mm	Where to store x of the corner of cell (0, 0)
+*	@param	y_mm	Where to store y of the corner of cell (0, 0)
+*	@date	10/17/2026
+*/
+void grid_origin(int16_t *x_mm, int16_t *y_mm)
+{
+	*x_mm = grid_origin_x;
+	*y_mm = grid_origin_y;
+}
+
+/**
+*	This method finds the cell a point is in
+*	@param	x_mm	x of the point
+*	@param	y_mm	y of the point
+*	@param	column	Where to store the column (x index)
+*	@param	row		Where to store the row (y index)
+*	@return	0 if the point is outside the grid
+*	@date	10/17/2026
+*/
+uint8_t grid_cell(int16_t x_mm, int16_t y_mm, uint8_t *column, uint8_t *row)
+{
+	long dx = (long) x_mm - grid_origin_x;
+	long dy = (long) y_mm - grid_origin_y;
+
+	if (dx < 0 || dy < 0 || dx >= (long) GRID_SIZE * GRID_CELL || dy >= (long) GRID_SIZE * GRID_CELL)
+		return 0;
+	*column = (uint8_t) (dx / GRID_CELL);
+	*row = (uint8_t) (dy / GRID_CELL);
+	return 1;
+}
+
+/**
+*	This method reads a cell
+*	@param	column	x index
+*	@param	row		y index
+*	@return	GRID_UNKNOWN .. GRID_OCCUPIED
+*	@date	10/17/2026
+*/
+uint8_t grid_get(uint8_t column, uint8_t row)
+{
+	if (column >= GRID_SIZE || row >= GRID_SIZE)
+		return GRID_UNKNOWN;
+	return (grid_cells[row * GRID_ROW_BYTES + column / 4] >> ((column & 3) * 2)) & 3;
+}
+
+/**
+*	This method reads the cell at a point
+*	@param	x_mm	x of the point
+*	@param	y_mm	y of the point
+*	@return	GRID_UNKNOWN .. GRID_OCCUPIED
+*	@date	10/17/2026
+*/
+uint8_t grid_at(int16_t x_mm, int16_t y_mm)
+{
+	uint8_t column, row;
+
+	if (!grid_cell(x_mm, y_mm, &column, &row))
+		return GRID_UNKNOWN;
+	return grid_get(column, row);
+}
+
+/**
+*	This method folds one observation into a cell
+*	@param	column	x index
+*	@param	row		y index
+*	@param	hit		1 if seen occupied, 0 if seen free
+*	@date	10/17/2026
+*/
+static void grid_observe(uint8_t column, uint8_t row, uint8_t hit)
+{
+	uint8_t *cell = &grid_cells[row * GRID_ROW_BYTES + column / 4];
+	uint8_t shift = (column & 3) * 2;
+	uint8_t value = (*cell >> shift) & 3;
+
+	/// A first hit says "seen", a second "occupied"; free views wear it down
+	if (hit)
+	{
+		if (value < GRID_SEEN)
+			grid_changed++;
+		value = value < GRID_SEEN ? GRID_SEEN : GRID_OCCUPIED;
+	}
+	else if (value != GRID_FREE)
+		value = value == GRID_UNKNOWN ? GRID_FREE : value - 1;
+	*cell = (*cell & ~(3 << shift)) | (value << shift);
+}
+
+/**
+*	This method adds one range reading
+*	@param	x_mm		x of the sensor
+*	@param	y_mm		y of the sensor
+*	@param	angle		Direction of the ray, binary angle
+*	@param	range_mm	Length of the ray
+*	@param	hit			1 if something was at the end of it
+*	@date	10/17/2026
+*/
+void grid_ray(int16_t x_mm, int16_t y_mm, uint16_t angle, uint16_t range_mm, uint8_t hit)
+{
+	int16_t cos_a = odom_cos(angle);
+	int16_t sin_a = odom_sin(angle);
+	uint8_t column, row, end_column = GRID_SIZE, end_row = GRID_SIZE;
+	uint8_t last_column = GRID_SIZE, last_row = GRID_SIZE;
+	uint16_t t;
+
+	if (hit && grid_cell(x_mm + (int16_t) (((long) range_mm * cos_a) >> ODOM_TRIG_Q),
+		y_mm + (int16_t) (((long) range_mm * sin_a) >> ODOM_TRIG_Q), &end_column, &end_row))
+		grid_observe(end_column, end_row, 1);
+
+	/// Half cell steps, so no cell the ray crosses is skipped by much
+	for (t = 0; t < range_mm; t += GRID_CELL / 2)
+	{
+		if (!grid_cell(x_mm + (int16_t) (((long) t * cos_a) >> ODOM_TRIG_Q),
+			y_mm + (int16_t) (((long) t * sin_a) >> ODOM_TRIG_Q), &column, &row))
+			break;
+		if (column == last_column && row == last_row)
+			continue;
+		last_column = column;
+		last_row = row;
+		if (column == end_column && row == end_row)
+			break;
+		grid_observe(column, row, 0);
+	}
+}
+
+/**
+*	This method checks a straight drive against the grid
+*	@param	x0_mm		x of the start
+*	@param	y0_mm		y of the start
+*	@param	x1_mm		x of the end
+*	@param	y1_mm		y of the end
+*	@param	clearance	mm to keep between the line and a seen cell
+*	@return	1 if a cell within clearance of the line was seen occupied
+*	@date	10/17/2026
+*/
+uint8_t grid_line_blocked(int16_t x0_mm, int16_t y0_mm, int16_t x1_mm, int16_t y1_mm, int16_t clearance)
+{
+	long dx = (long) x1_mm - x0_mm;
+	long dy = (long) y1_mm - y0_mm;
+	long steps = (labs(dx) > labs(dy) ? labs(dx) : labs(dy)) / (GRID_CELL / 2) + 1;
+	int8_t reach = (int8_t) ((clearance + GRID_CELL - 1) / GRID_CELL);
+	int8_t i, j;
+	long k;
+	uint8_t column, row;
+
+	/// Every half cell along the line, every cell within reach of it
+	for (k = 0; k <= steps; k++)
+	{
+		if (!grid_cell(x0_mm + (int16_t) (dx * k / steps), y0_mm + (int16_t) (dy * k / steps), &column, &row))
+			continue;
+		for (i = -reach; i <= reach; i++)
+			for (j = -reach; j <= reach; j++)
+				if (grid_get(column + i, row + j) >= GRID_SEEN)
+					return 1;
+	}
+	return 0;
+}
+
+/**
+*	This method copies one row of packed cells
+*	@param	row		Which row
+*	@param	dest	GRID_ROW_BYTES bytes
+*	@return	1 if any cell of the row is known
+*	@date	10/17/2026
+*/
+uint8_t grid_row(uint8_t row, uint8_t *dest)
+{
+	uint8_t i, known = 0;
+
+	for (i = 0; i < GRID_ROW_BYTES; i++)
+	{
+		dest[i] = grid_cells[row * GRID_ROW_BYTES + i];
+		known |= dest[i];
+	}
+	return known != 0;
+}
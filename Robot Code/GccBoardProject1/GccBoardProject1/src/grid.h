@@ -0,0 +1,69 @@
+/**
+*	@file	grid.h
+*	@brief	Occupancy grid of the arena in 2 bits per cell, filled from the
+*			sweep's rays and the odometry pose, so what the robot has seen
+*			outlasts the next sweep and motions can keep clear of it.
+*	@date	10/17/2026
+*/
+
+#ifndef GRID_H
+#define GRID_H
+
+#include <inttypes.h>
+
+/// Cells per side and their size: 64 x 10 cm = 6.4 m square in 1 KB
+#define GRID_SIZE 64
+#define GRID_CELL 100	// mm
+/// Bytes of one row of cells, 4 cells per byte
+#define GRID_ROW_BYTES (GRID_SIZE / 4)
+
+/// What a cell holds: a small counter, seen free lowers it and seen hit raises it
+#define GRID_UNKNOWN	0
+#define GRID_FREE		1
+#define GRID_SEEN		2	// hit once more than seen free
+#define GRID_OCCUPIED	3
+
+/// \brief Forget everything and place the grid
+/// \param origin_x_mm x of the corner of cell (0, 0) in the odometry frame
+/// \param origin_y_mm y of the corner of cell (0, 0) in the odometry frame
+void grid_clear(int16_t origin_x_mm, int16_t origin_y_mm);
+
+/// \brief Count of changes that can block a way: cells newly seen occupied,
+/// and clears. Compare two readings to know if a plan may be out of date.
+/// \return the count, wrapping at 256
+uint8_t grid_changes(void);
+
+/// \brief Where the corner of cell (0, 0) is, in mm of the odometry frame
+void grid_origin(int16_t *x_mm, int16_t *y_mm);
+
+/// \brief Find the cell a point is in
+/// \return 0 if the point is outside the grid
+uint8_t grid_cell(int16_t x_mm, int16_t y_mm, uint8_t *column, uint8_t *row);
+
+/// \return GRID_UNKNOWN .. GRID_OCCUPIED for a cell; outside is unknown
+uint8_t grid_get(uint8_t column, uint8_t row);
+
+/// \return GRID_UNKNOWN .. GRID_OCCUPIED at a point in the odometry frame
+uint8_t grid_at(int16_t x_mm, int16_t y_mm);
+
+/// \brief Add one range reading: the cells along the ray are seen free and,
+/// on a hit, the cell at its end is seen occupied
+/// \param x_mm x of the sensor
+/// \param y_mm y of the sensor
+/// \param angle direction of the ray, binary angle (see odometry.h)
+/// \param range_mm length of the ray
+/// \param hit 1 if something was there, 0 if the ray only saw free space
+void grid_ray(int16_t x_mm, int16_t y_mm, uint16_t angle, uint16_t range_mm, uint8_t hit);
+
+/// \brief Check a straight drive against what the grid knows
+/// \param clearance mm to keep between the line and a seen cell
+/// \return 1 if a cell within clearance of the line was seen occupied
+uint8_t grid_line_blocked(int16_t x0_mm, int16_t y0_mm, int16_t x1_mm, int16_t y1_mm, int16_t clearance);
+
+/// \brief Copy one row of packed cells, 4 per byte, column 0 in the low bits
+/// \param row which row (y index)
+/// \param dest GRID_ROW_BYTES bytes
+/// \return 1 if any cell of the row is known
+uint8_t grid_row(uint8_t row, uint8_t *dest);
+
+#endif
@@ -0,0 +1,127 @@
+/**
+*	@file	heading.c
+*	@brief	Fixed-point PID heading hold for straight moves.
+*	@date	10/17/2026
+*/
+
+#include <stdlib.h>
+#include "heading.h"
+
+static int16_t heading_kp = HEADING_KP_DEFAULT;
+static int16_t heading_ki = HEADING_KI_DEFAULT;
+static int16_t heading_kd = HEADING_KD_DEFAULT;
+
+/// Degrees turned since heading_reset(), counterclockwise positive
+static int16_t heading_turned = 0;
+/// Accumulated error in degree milliseconds
+static int32_t heading_integral = 0;
+/// Error of the previous call, for the derivative
+static int16_t heading_last_error = 0;
+static int16_t heading_trim_last = 0;
+
+/**
+*	This method sets the controller gains
+*	@param	kp		mm/s per degree, Q8
+*	@param	ki		mm/s per degree second, Q8
+*	@param	kd		mm/s per degree/s, Q8
+*	@date	10/17/2026
+*/
+void heading_set_gains(int16_t kp, int16_t ki, int16_t kd)
+{
+	heading_kp = kp;
+	heading_ki = ki;
+	heading_kd = kd;
+	heading_integral = 0;
+}
+
+/**
+*	This method reads the controller gains
+*	@param	kp		Where to store the proportional gain
+*	@param	ki		Where to store the integral gain
+*	@param	kd		Where to store the derivative gain
+*	@date	10/17/2026
+*/
+void heading_get_gains(int16_t *kp, int16_t *ki, int16_t *kd)
+{
+	*kp = heading_kp;
+	*ki = heading_ki;
+	*kd = heading_kd;
+}
+
+/**
+*	This method holds the current heading from here on
+*	@date	10/17/2026
+*/
+void heading_reset(void)
+{
+	heading_turned = 0;
+	heading_integral = 0;
+	heading_last_error = 0;
+	heading_trim_last = 0;
+}
+
+/**
+*	This method trims the wheel speeds toward the held heading
+*	@param	angle	Degrees turned since the last call
+*	@param	elapsed	ms between the sensor frames the angle was turned in
+*	@param	speed	Wheel speed of the straight move in mm/s
+*	@param	right	Where to store the right wheel speed
+*	@param	left	Where to store the left wheel speed
+*	@date	10/17/2026
+*/
+void heading_trim(int16_t angle, uint16_t elapsed, int16_t speed, int16_t *right, int16_t *left)
+{
+	int16_t error, limit;
+	int32_t trim, integral_limit;
+
+	heading_turned += angle;
+	error = heading_turned;
+
+	/// The trim may take at most a quarter of the wheel speed
+	limit = (int16_t) ((int32_t) abs(speed) * HEADING_TRIM_MAX / 100);
+
+	/// Only as much integral as the limit can use, so it unwinds quickly
+	heading_integral += (int32_t) error * (long) elapsed;
+	integral_limit = heading_ki > 0 ? ((int32_t) limit << HEADING_Q) * 1000 / heading_ki : 0;
+	if (heading_integral > integral_limit)
+		heading_integral = integral_limit;
+	if (heading_integral < -integral_limit)
+		heading_integral = -integral_limit;
+
+	trim = (int32_t) heading_kp * error + heading_integral * heading_ki / 1000;
+	if (elapsed > 0)
+		trim += (int32_t) heading_kd * (error - heading_last_error) * 1000 / (long) elapsed;
+	trim >>= HEADING_Q;
+	heading_last_error = error;
+
+	if (trim > limit)
+		trim = limit;
+	if (trim < -limit)
+		trim = -limit;
+	heading_trim_last = (int16_t) trim;
+
+	/// Turned counterclockwise: slow the right wheel and speed up the left.
+	/// The same holds when backing up.
+	*right = speed - heading_trim_last;
+	*left = speed + heading_trim_last;
+}
+
+/**
+*	This method returns the heading error
+*	@return	degrees off the held heading, counterclockwise positive
+*	@date	10/17/2026
+*/
+int16_t heading_error(void)
+{
+	return heading_turned;
+}
+
+/**
+*	This method returns the last trim
+*	@return	mm/s taken off the right wheel and added to the left
+*	@date	10/17/2026
+*/
+int16_t heading_correction(void)
+{
+	return heading_trim_last;
+}
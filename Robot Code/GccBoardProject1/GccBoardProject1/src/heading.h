@@ -0,0 +1,51 @@
+/**
+*	@file	heading.h
+*	@brief	Fixed-point PID heading hold for straight moves. Trims the wheel
+*			speeds from the angle the Create reports so the robot keeps the
+*			heading it started with.
+*	@date	10/17/2026
+*/
+
+#ifndef HEADING_H
+#define HEADING_H
+
+#include <inttypes.h>
+
+/// Fractional bits of the gains (Q8)
+#define HEADING_Q 8
+/// Default gains: mm/s of trim per degree, per degree second and per degree/s
+#define HEADING_KP_DEFAULT	2048	// 8.0
+#define HEADING_KI_DEFAULT	512		// 2.0
+#define HEADING_KD_DEFAULT	128		// 0.5
+/// Largest trim in percent of the wheel speed, so a wheel never reverses
+#define HEADING_TRIM_MAX 25
+
+/// \brief Set the controller gains, in Q8
+/// \param kp mm/s of trim per degree of error
+/// \param ki mm/s of trim per degree second of error
+/// \param kd mm/s of trim per degree/s the error grows
+void heading_set_gains(int16_t kp, int16_t ki, int16_t kd);
+
+/// \brief Read the controller gains, in Q8
+void heading_get_gains(int16_t *kp, int16_t *ki, int16_t *kd);
+
+/// \brief Hold the current heading from here on; clears the error and the
+/// integral. Call at the start of each straight move.
+void heading_reset(void);
+
+/// \brief Fold in the angle turned since the last call and trim the wheels
+/// \param angle degrees turned, counterclockwise positive (oi_t angle)
+/// \param elapsed ms between the sensor frames the angle was turned in; the
+/// integral and derivative go by it, not by how often this is called
+/// \param speed wheel speed of the straight move in mm/s
+/// \param right where to store the trimmed right wheel speed
+/// \param left where to store the trimmed left wheel speed
+void heading_trim(int16_t angle, uint16_t elapsed, int16_t speed, int16_t *right, int16_t *left);
+
+/// \return degrees the robot is off the held heading, counterclockwise positive
+int16_t heading_error(void);
+
+/// \return the last trim in mm/s; positive slows the right wheel
+int16_t heading_correction(void);
+
+#endif
@@ -1,56 +1,87 @@
-/**
-*	@file	main.c
-*	@brief	Contains the main method.
-*
-*	@author Robert Guetzlaff
-*
-*	@date	7/6/2016
-*/
-
-#include <asf.h>
-#include <avr/io.h>
-#include "lcd.h"
-#include "util.h"
-#include "open_interface.h"
-#include "sweep.h"
-
-int i;
-
-/**
-*	This is the main method for the application.
-*	@author		Robert Guetzlaff
-*	@date		7/6/2016
-*/
-int main (void)
-{
-	/// Initial setup
-	board_init();
-	lcd_init();
-	serial_init();
-	oi_set_wheels(0,0);
-	
-	/// The note array to play the song
-	/// The notes start at 31 to 127 
-	unsigned char notes[] = {69,69,69, 65, 72, 69, 65, 72, 69};
-	unsigned char notes_duration[] = {50,50, 50, 38, 13, 50, 38, 13, 100}; 
-	
-	oi_set_wheels(0,0);
-	oi_t *sensor_data = oi_alloc();
-	oi_init(sensor_data);
-	
-	lprintf("HI");
-	
-	oi_load_song(1, 9, notes, notes_duration); 
-	// oi_play_song(1);
-	oi_set_wheels(0,0);
-	
-	wait_ms(2000);
-	
-	/// Infinite loop for application
-	while (1)
-	{
-		oi_update(sensor_data);
-		movement(sensor_data);
-		wait_ms(2000);
-	}
-}
+/**
+*	@file	main.c
+*	@brief	Contains the main method.
+*
+*	@author Robert Guetzlaff
+*
+*	@date	7/6/2016
+*/
+
+#include <asf.h>
+#include <avr/io.h>
+#include "lcd.h"
+#include "util.h"
+#include "open_interface.h"
+#include "sweep.h"
+#include "battery.h"
+
+int i;
+
+/// Sensor packets streamed from the Create for the movement and safety checks,
+/// for following script driven motion and for the battery governor. 46 bytes
+/// per frame with header, count, IDs and checksum, 85 fit in 15 ms at 57600;
+/// without the last packet (voltage) 43, which just fits the 43 of the 28800
+/// baud fallback rate.
+static const uint8_t stream_packets[] = {
+	OI_SENSOR_BUMPS_WHEELDROPS,
+	OI_SENSOR_CLIFF_LEFT,
+	OI_SENSOR_CLIFF_FRONT_LEFT,
+	OI_SENSOR_CLIFF_FRONT_RIGHT,
+	OI_SENSOR_CLIFF_RIGHT,
+	OI_SENSOR_DISTANCE,
+	OI_SENSOR_ANGLE,
+	OI_SENSOR_CLIFF_LEFT_SIGNAL,
+	OI_SENSOR_CLIFF_FRONT_LEFT_SIGNAL,
+	OI_SENSOR_CLIFF_FRONT_RIGHT_SIGNAL,
+	OI_SENSOR_CLIFF_RIGHT_SIGNAL,
+	OI_SENSOR_REQUESTED_RIGHT_VELOCITY,
+	OI_SENSOR_REQUESTED_LEFT_VELOCITY,
+	OI_SENSOR_CURRENT,
+	OI_SENSOR_CHARGE,
+	OI_SENSOR_VOLTAGE
+};
+
+/**
+*	This is the main method for the application.
+*	@author		Robert Guetzlaff
+*	@date		7/6/2016
+*/
+int main (void)
+{
+	/// Initial setup
+	board_init();
+	lcd_init();
+	clock_init();
+	serial_init();
+	oi_set_wheels(0,0);
+	
+	/// The note array to play the song
+	/// The notes start at 31 to 127 
+	unsigned char notes[] = {69,69,69, 65, 72, 69, 65, 72, 69};
+	unsigned char notes_duration[] = {50,50, 50, 38, 13, 50, 38, 13, 100}; 
+	
+	oi_set_wheels(0,0);
+	oi_t *sensor_data = oi_alloc();
+	oi_init(sensor_data);
+	/// Sensor data now arrives in the background every 15 ms
+	if (!oi_stream_start(sensor_data, stream_packets, sizeof(stream_packets)))
+		oi_stream_start(sensor_data, stream_packets, sizeof(stream_packets) - 1);
+	battery_update(sensor_data);
+	
+	lprintf("HI %lu baud", oi_link()->baud);
+	
+	oi_load_song(1, 9, notes, notes_duration); 
+	// oi_play_song(1);
+	oi_set_wheels(0,0);
+	
+	wait_ms(2000);
+	
+	/// Infinite loop for application
+	while (1)
+	{
+		oi_update(sensor_data);
+		battery_update(sensor_data);
+		movement(sensor_data);
+		wait_ms(2000);
+	}
+}
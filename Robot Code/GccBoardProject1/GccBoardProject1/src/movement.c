@@ -1,111 +1,916 @@
-/**
-*	@file	movement.c
-*	@brief	Contains the functions for moving the robot.
-*	@author Robert Guetzlaff
-*	@date	7/5/2016
-*/
-
-#include "util.h"
-#include "open_interface.h" 
-#include "lcd.h"
-#include "math.h"
-#include "movement.h"
-
-/**
-*	This method moves the robot so many meters
-*	@author	Robert Guetzlaff
-*	@param	sensor			Instance of the robot
-*	@param	notcentimeters	Distance to move in meters
-*	@date 7/6/2016
-*/
-void move(oi_t *sensor, int notcentimeters)
-{
-	int sum = 0;
-	int speed = 250;
-	if(notcentimeters < 0)
-	{
-		speed = speed * -1;
-		notcentimeters = notcentimeters * -1;
-	}
-	/// Move forward; full speed
-	oi_set_wheels(speed, speed); 
-	
-	while(sum < notcentimeters)
-	{
-		oi_update(sensor);
-		if(sensor->distance < 0)
-		{
-			sum -= sensor->distance;
-		}
-		else
-		{
-			sum += sensor->distance;
-		}
-	}
-	/// Stop
-	oi_set_wheels(0, 0); 
-}
-
-/**
-*	This method moves the robot so many centimeters
-*	@author Nicus Hicks
-*	@param	sensor			Instance of the robot
-*	@param	distance		Distance to move in centimeters
-*	@date 7/6/2016
-*/
-int careMove(oi_t* sensor, int distance, int speed)
-{
-	int sum = 0;
-	oi_set_wheels(speed, speed);
-	while(sum < distance)
-	{
-		oi_update(sensor);
-		sum += sensor->distance;
-		if(sensor->bumper_left || sensor->bumper_right || sensor->cliff_frontleft_signal || sensor ->cliff_frontright_signal)
-			break;
-	}
-	oi_set_wheels(0, 0);
-	/// The distance still needed to travel
-	return distance - sum; 
-}
-
-/**
-*	This method turns the robot 
-*	@author Zach Newton and Nathan Francque
-*	@param	sensor			Instance of the robot
-*	@param	degrees			Degrees to turn. Positive for clockwise. Negative for counterclockwise
-*	@param	speed			Speed to turn to robot
-*	@date 7/6/2016
-*/
-void turn(oi_t *sensor, int degrees, int speed)
-{
-	int angleChange = 0;
-	int direction = 1;
-	
-	if(degrees < 0)
-		direction = -1;
-		
-	degrees = fabs(degrees);
-	oi_set_wheels(direction * speed, direction * (-1 * speed));
-	
-	if(degrees > 0)
-	{	
-		while(angleChange < degrees)
-		{
-			oi_update(sensor);
-			angleChange += (sensor->angle);
-			lprintf("%d", angleChange);
-		}
-	}
-	///broken
-	if(degrees < 0)
-	{
-		while(angleChange < degrees)
-		{
-			oi_update(sensor);
-			angleChange -= (sensor->angle);
-			lprintf("%d", angleChange);
-		}
-	}
-	oi_set_wheels(0, 0);
-}
\ No newline at end of file
+/**
+*	@file	movement.c
+*	@brief	Contains the functions for moving the robot.
+*	@author Robert Guetzlaff
+*	@date	7/5/2016
+*/
+
+#include "util.h"
+#include "open_interface.h" 
+#include "lcd.h"
+#include "math.h"
+#include "stdlib.h"
+#include "movement.h"
+#include "drive.h"
+#include "heading.h"
+#include "odometry.h"
+#include "pursuit.h"
+
+/// Sensor packets the motion loops read: bumpers, cliffs, distance, angle and
+/// the front cliff signals. 13 bytes per poll instead of the 52 byte GROUP6
+/// packet; the cliffs are there for the safety reflex.
+static const uint8_t motion_packets[] = {
+	OI_SENSOR_BUMPS_WHEELDROPS,
+	OI_SENSOR_CLIFF_LEFT,
+	OI_SENSOR_CLIFF_FRONT_LEFT,
+	OI_SENSOR_CLIFF_FRONT_RIGHT,
+	OI_SENSOR_CLIFF_RIGHT,
+	OI_SENSOR_DISTANCE,
+	OI_SENSOR_ANGLE,
+	OI_SENSOR_CLIFF_FRONT_LEFT_SIGNAL,
+	OI_SENSOR_CLIFF_FRONT_RIGHT_SIGNAL
+};
+
+/// Largest wait (mm or degrees) in one script step. The Create ignores the
+/// serial port while a wait runs, so this bounds how late an abort lands.
+#define SCRIPT_CHUNK_DISTANCE	50
+#define SCRIPT_CHUNK_ANGLE		15
+/// Each wait step takes 3 bytes; the drive and stop commands take 5 each
+#define SCRIPT_MAX_CHUNKS		((OI_SCRIPT_MAX_LENGTH - 10) / 3)
+/// Distance between the wheels of the Create in mm
+#define WHEEL_BASE				258
+
+/// Packets read while a script runs when the sensor data is not streamed
+static const uint8_t script_packets[] = {
+	OI_SENSOR_BUMPS_WHEELDROPS,
+	OI_SENSOR_REQUESTED_RIGHT_VELOCITY,
+	OI_SENSOR_REQUESTED_LEFT_VELOCITY
+};
+
+/// State of the script driven motion
+static uint8_t script_status = MOTION_SCRIPT_IDLE;
+/// Set once the Create reports the script's wheel speeds
+static uint8_t script_moving = 0;
+/// clock_ms() after which a script that never finished is aborted
+static unsigned long script_deadline = 0;
+/// Completion notification for the running script
+static void (*script_done)(uint8_t status) = 0;
+
+/**
+*	This method ends the script driven motion and notifies the caller
+*	@param	status		MOTION_SCRIPT_DONE or MOTION_SCRIPT_ABORTED
+*	@date 10/17/2026
+*/
+static void script_finish(uint8_t status)
+{
+	script_status = status;
+	if (script_done)
+		script_done(status);
+}
+
+/**
+*	This method uploads and plays a drive + wait + stop script
+*	@param	wait_opcode		OI_OPCODE_WAIT_DISTANCE or OI_OPCODE_WAIT_ANGLE
+*	@param	amount			Distance (mm) or angle (degrees) to wait for
+*	@param	right			Right wheel speed in mm/s
+*	@param	left			Left wheel speed in mm/s
+*	@param	duration_ms		Expected time for the motion
+*	@param	done			Completion notification
+*	@date 10/17/2026
+*/
+static void script_start(uint8_t wait_opcode, int amount, int right, int left, unsigned long duration_ms, void (*done)(uint8_t status))
+{
+	uint8_t script[OI_SCRIPT_MAX_LENGTH];
+	uint8_t length = 0;
+	int chunk_size = (wait_opcode == OI_OPCODE_WAIT_DISTANCE) ? SCRIPT_CHUNK_DISTANCE : SCRIPT_CHUNK_ANGLE;
+	int chunk;
+
+	/// Long motions use bigger steps so the script still fits
+	if (abs(amount) > chunk_size * SCRIPT_MAX_CHUNKS)
+		chunk_size = (abs(amount) + SCRIPT_MAX_CHUNKS - 1) / SCRIPT_MAX_CHUNKS;
+
+	script[length++] = OI_OPCODE_DRIVE_WHEELS;
+	script[length++] = right >> 8;
+	script[length++] = right & 0xff;
+	script[length++] = left >> 8;
+	script[length++] = left & 0xff;
+
+	while (amount != 0)
+	{
+		chunk = amount;
+		if (chunk > chunk_size)
+			chunk = chunk_size;
+		if (chunk < -chunk_size)
+			chunk = -chunk_size;
+		script[length++] = wait_opcode;
+		script[length++] = chunk >> 8;
+		script[length++] = chunk & 0xff;
+		amount -= chunk;
+	}
+
+	script[length++] = OI_OPCODE_DRIVE_WHEELS;
+	script[length++] = 0;
+	script[length++] = 0;
+	script[length++] = 0;
+	script[length++] = 0;
+
+	script_done = done;
+	script_moving = 0;
+	script_deadline = clock_ms() + 2 * duration_ms + 1000;
+	script_status = MOTION_SCRIPT_RUNNING;
+
+	/// The script sets the wheels from here on, so the speed profile lets go
+	drive_set_now(0, 0);
+	oi_script_load(script, length);
+	oi_script_play();
+}
+
+/**
+*	This method starts a move that the Create finishes on its own with a script
+*	@param	millimeters		Distance to move. Negative moves backwards
+*	@param	speed			Wheel speed in mm/s
+*	@param	done			Completion notification; may be 0
+*	@date 10/17/2026
+*/
+void move_script_start(int millimeters, int speed, void (*done)(uint8_t status))
+{
+	speed = abs(drive_clamp(speed));
+	if (millimeters < 0)
+		speed = -speed;
+	if (speed == 0)
+		return;
+	script_start(OI_OPCODE_WAIT_DISTANCE, millimeters, speed, speed,
+		(unsigned long) abs(millimeters) * 1000 / abs(speed), done);
+}
+
+/**
+*	This method starts a turn that the Create finishes on its own with a script
+*	@param	degrees			Degrees to turn, same direction convention as turn()
+*	@param	speed			Wheel speed in mm/s
+*	@param	done			Completion notification; may be 0
+*	@date 10/17/2026
+*/
+void turn_script_start(int degrees, int speed, void (*done)(uint8_t status))
+{
+	speed = abs(drive_clamp(speed));
+	if (degrees < 0)
+		speed = -speed;
+	if (speed == 0)
+		return;
+	/// Spinning in place turns 2 * speed / WHEEL_BASE radians per second
+	script_start(OI_OPCODE_WAIT_ANGLE, degrees, speed, -speed,
+		(unsigned long) abs(degrees) * 1000 * WHEEL_BASE / (114L * abs(speed)), done);
+}
+
+/**
+*	This method checks on a script driven move or turn
+*	@param	sensor			Instance of the robot, updated by this call
+*	@return	MOTION_SCRIPT_IDLE, _RUNNING, _DONE or _ABORTED
+*	@date 10/17/2026
+*/
+uint8_t motion_script_poll(oi_t *sensor)
+{
+	if (script_status != MOTION_SCRIPT_RUNNING)
+		return script_status;
+
+	/// A query is only answered between wait steps, so streaming is preferred
+	if (oi_stream_active())
+		oi_update(sensor);
+	else
+		oi_update_list(sensor, script_packets, sizeof(script_packets));
+
+	if (sensor->bumper_left || sensor->bumper_right || clock_ms() > script_deadline)
+	{
+		motion_script_abort();
+	}
+	else if (sensor->requested_right_velocity != 0 || sensor->requested_left_velocity != 0)
+	{
+		script_moving = 1;
+	}
+	/// The script's last command sets both wheels back to 0
+	else if (script_moving)
+	{
+		script_finish(MOTION_SCRIPT_DONE);
+	}
+
+	return script_status;
+}
+
+/**
+*	This method returns the state of the script driven move or turn
+*	@return	MOTION_SCRIPT_IDLE, _RUNNING, _DONE or _ABORTED
+*	@date 10/17/2026
+*/
+uint8_t motion_script_status(void)
+{
+	return script_status;
+}
+
+/**
+*	This method stops a script driven move or turn early
+*	@date 10/17/2026
+*/
+void motion_script_abort(void)
+{
+	if (script_status != MOTION_SCRIPT_RUNNING)
+		return;
+	/// Restarting the OI ends the script as soon as the current wait step is over
+	oi_byte_tx(OI_OPCODE_START);
+	oi_byte_tx(OI_OPCODE_FULL);
+	oi_wheels_invalidate();
+	drive_set_now(0, 0);
+	script_finish(MOTION_SCRIPT_ABORTED);
+}
+
+/// What the stepped motion is doing
+#define MOTION_KIND_MOVE	0
+#define MOTION_KIND_CARE	1
+#define MOTION_KIND_TURN	2
+#define MOTION_KIND_ARC		3
+#define MOTION_KIND_PATH	4
+/// Most segments in a planned motion
+#define MOTION_PLAN_MAX		4
+/// Slowest speed an arc brakes to, so it still reaches its end
+#define ARC_SPEED_MIN		20
+/// Half the width of the Create; its center keeps this far from obstacles plus any clearance
+#define ROBOT_RADIUS		165
+/// Straight moves end with a slow final piece: its speed (mm/s) and length (mm),
+/// and how far the Create rolls on once told to stop from it
+#define MOTION_CREEP_SPEED		50
+#define MOTION_CREEP_DISTANCE	20
+#define MOTION_CREEP_COAST		2
+/// Longest wait for the robot to come to rest before the final error is taken
+#define MOTION_SETTLE_MS		300
+/// Longest wait of the blocking motions for the next streamed frame
+#define MOTION_FRAME_WAIT_MS	50
+/// A motion that sees no new frame for this long stops where it is
+#define MOTION_FRAME_TIMEOUT_MS	200
+/// Turns learn how far they overshoot in speed bands of this many mm/s
+#define TURN_BAND_WIDTH			50
+#define TURN_BANDS				10
+/// Most degrees a turn may end early to make up for its overshoot
+#define TURN_LEAD_MAX			30
+
+/// One piece of a planned motion
+typedef struct {
+	uint8_t kind;		// MOTION_KIND_
+	uint8_t by_angle;	// arcs: amount is degrees of heading instead of mm of path
+	int16_t radius;		// arcs: mm, positive to the left
+	int amount;			// mm or degrees; negative backs up, or turns clockwise
+} motion_segment_t;
+
+/// State of the stepped motion
+static uint8_t motion_state = MOTION_IDLE;
+static uint8_t motion_kind = MOTION_KIND_MOVE;
+/// Distance (mm) or angle (degrees) to cover, always positive, and how much is covered
+static int motion_goal = 0;
+static int motion_covered = 0;
+/// Wheel speed in mm/s, negative for backwards or clockwise
+static int16_t motion_speed = 0;
+/// Arc being driven: radius, whether it ends on heading, and the speed last sent
+static int16_t motion_radius = 0;
+static uint8_t motion_by_angle = 0;
+static int16_t motion_arc_speed = 0;
+
+/// Time between the frames steps act on (ms, averaged), and when the frame
+/// of the last step came
+static int16_t motion_poll_ms = 20;
+static unsigned long motion_frame_time = 0;
+/// Sensor frame the last step acted on, and the running distance and angle
+/// totals it carried. The motion takes its own differences of the totals, so
+/// oi_update() calls elsewhere in the loop do not take movement away from it.
+static uint16_t motion_seq = 0;
+static int16_t motion_distance_sum = 0;
+static int16_t motion_angle_sum = 0;
+/// Set once a straight move has stopped and waits to come to rest; when it
+/// stopped, and how many frames in a row saw no movement
+static uint8_t motion_settling = 0;
+static unsigned long motion_stop_time = 0;
+static uint8_t motion_still = 0;
+
+/// Degrees turns overshot, learned per speed band, and how early the
+/// running turn ends because of it
+static int8_t turn_overshoot[TURN_BANDS];
+static int motion_lead = 0;
+
+/// Segments of the running motion, the one being driven, and the speed they share
+static motion_segment_t motion_plan[MOTION_PLAN_MAX];
+static uint8_t motion_plan_count = 0;
+static uint8_t motion_plan_next = 0;
+static int16_t motion_plan_speed = 0;
+
+/**
+*	This method drives the current arc at a new speed
+*	@param	speed		mm/s of the center of the robot
+*	@date 10/17/2026
+*/
+static void motion_arc_drive(int16_t speed)
+{
+	if (speed == motion_arc_speed)
+		return;
+	motion_arc_speed = speed;
+	oi_set_drive(speed, motion_radius);
+	/// The outer wheel runs faster by half the wheel base over the radius
+	drive_assume((int16_t) ((long) speed * (motion_radius + WHEEL_BASE / 2) / motion_radius),
+		(int16_t) ((long) speed * (motion_radius - WHEEL_BASE / 2) / motion_radius));
+}
+
+/**
+*	This method starts driving one segment of the plan
+*	@param	segment		Segment to drive
+*	@date 10/17/2026
+*/
+static void motion_segment_start(const motion_segment_t *segment)
+{
+	motion_kind = segment->kind;
+	motion_by_angle = segment->by_angle;
+	motion_radius = segment->radius;
+	motion_goal = abs(segment->amount);
+	motion_covered = 0;
+	motion_speed = segment->amount < 0 ? -motion_plan_speed : motion_plan_speed;
+	motion_settling = 0;
+	/// A turn ends early by what it overshot last time at this speed
+	motion_lead = 0;
+	if (motion_kind == MOTION_KIND_TURN)
+		motion_lead = MIN(turn_overshoot[MIN(motion_plan_speed / TURN_BAND_WIDTH, TURN_BANDS - 1)], motion_goal / 2);
+
+	heading_reset();
+	if (motion_kind == MOTION_KIND_PATH)
+		return;
+	if (motion_kind == MOTION_KIND_TURN)
+		drive_set(motion_speed, -motion_speed);
+	else if (motion_kind == MOTION_KIND_ARC)
+	{
+		motion_arc_speed = 0;
+		motion_arc_drive(motion_speed);
+	}
+	else
+		drive_set(motion_speed, motion_speed);
+}
+
+/**
+*	This method ends the stepped motion and stops the wheels
+*	@param	status		MOTION_DONE, MOTION_STOPPED or MOTION_CANCELLED
+*	@date 10/17/2026
+*/
+static void motion_finish(uint8_t status)
+{
+	drive_set_now(0, 0);
+	motion_state = status;
+}
+
+/**
+*	This method starts the segments in motion_plan
+*	@param	count		Number of segments
+*	@param	speed		Wheel speed in mm/s
+*	@date 10/17/2026
+*/
+static void motion_plan_start(uint8_t count, int speed)
+{
+	oi_frame_t frame;
+
+	/// Movement counts from the newest frame on
+	motion_seq = oi_frame_copy(&frame);
+	motion_distance_sum = frame.distance_sum;
+	motion_angle_sum = frame.angle_sum;
+	/// A polled frame, or one from before the stream started, may be long
+	/// gone; the first step then times from here
+	motion_frame_time = clock_ms();
+	if (oi_stream_active() && motion_frame_time - frame.time_ms < MOTION_FRAME_TIMEOUT_MS)
+		motion_frame_time = frame.time_ms;
+	motion_plan_count = count;
+	motion_plan_next = 0;
+	motion_plan_speed = abs(drive_clamp(speed));
+	/// At 0 mm/s it would never get anywhere
+	if (!motion_plan_speed)
+	{
+		motion_finish(MOTION_STOPPED);
+		return;
+	}
+	motion_state = MOTION_RUNNING;
+	motion_segment_start(&motion_plan[0]);
+}
+
+/**
+*	This method starts a stepped motion of a single segment
+*	@param	kind		MOTION_KIND_MOVE, _CARE or _TURN
+*	@param	amount		Distance or angle; the sign gives the direction
+*	@param	speed		Wheel speed in mm/s
+*	@date 10/17/2026
+*/
+static void motion_start(uint8_t kind, int amount, int speed)
+{
+	motion_plan[0].kind = kind;
+	motion_plan[0].by_angle = 0;
+	motion_plan[0].radius = 0;
+	motion_plan[0].amount = amount;
+	motion_plan_start(1, speed);
+}
+
+/**
+*	This method starts a move of so many millimeters
+*	@param	millimeters		Distance to move. Negative moves backwards
+*	@param	speed			Wheel speed in mm/s
+*	@date 10/17/2026
+*/
+void move_start(int millimeters, int speed)
+{
+	motion_start(MOTION_KIND_MOVE, millimeters, speed);
+}
+
+/**
+*	This method starts a move that stops early for bumpers and cliffs
+*	@param	distance		Distance to move in mm. Negative moves backwards
+*	@param	speed			Wheel speed in mm/s
+*	@date 10/17/2026
+*/
+void care_move_start(int distance, int speed)
+{
+	motion_start(MOTION_KIND_CARE, distance, speed);
+}
+
+/**
+*	This method starts a turn in place
+*	@param	degrees			Degrees to turn, same direction convention as turn()
+*	@param	speed			Wheel speed in mm/s
+*	@date 10/17/2026
+*/
+void turn_start(int degrees, int speed)
+{
+	motion_start(MOTION_KIND_TURN, degrees, speed);
+}
+
+/**
+*	This method starts a turn to an absolute heading, the shorter way round
+*	@param	heading			Heading in degrees, counterclockwise positive, as odometry keeps it
+*	@param	speed			Wheel speed in mm/s
+*	@date 10/17/2026
+*/
+void turn_to_heading_start(int heading, int speed)
+{
+	odom_pose_t pose;
+
+	odom_get(&pose);
+	/// Binary angles wrap, so their difference is already the shorter way
+	turn_start(odom_angle_to_deg(odom_deg_to_angle(heading) - pose.heading), speed);
+}
+
+/**
+*	This method starts an arc that ends after so much path
+*	@param	radius			mm to the center of the circle, positive to the left; 0 ends at once, MOTION_STOPPED
+*	@param	millimeters		Path length of the center of the robot. Negative backs up
+*	@param	speed			Speed in mm/s
+*	@date 10/17/2026
+*/
+void arc_start(int radius, int millimeters, int speed)
+{
+	motion_plan[0].kind = MOTION_KIND_ARC;
+	motion_plan[0].by_angle = 0;
+	motion_plan[0].radius = radius;
+	motion_plan[0].amount = millimeters;
+	/// There is no arc of radius 0; end at once, not with the last status
+	if (radius == 0)
+		motion_finish(MOTION_STOPPED);
+	else
+		motion_plan_start(1, speed);
+}
+
+/**
+*	This method starts a forward arc that ends after so much change of heading
+*	@param	radius			mm to the center of the circle, positive to the left; 0 ends at once, MOTION_STOPPED
+*	@param	degrees			Change of heading
+*	@param	speed			Speed in mm/s
+*	@date 10/17/2026
+*/
+void arc_turn_start(int radius, int degrees, int speed)
+{
+	motion_plan[0].kind = MOTION_KIND_ARC;
+	motion_plan[0].by_angle = 1;
+	motion_plan[0].radius = radius;
+	motion_plan[0].amount = abs(degrees);
+	/// There is no arc of radius 0; end at once, not with the last status
+	if (radius == 0)
+		motion_finish(MOTION_STOPPED);
+	else
+		motion_plan_start(1, speed);
+}
+
+/**
+*	This method plans and starts a detour around an object straight ahead
+*	@param	distance		mm from the front of the robot to the near side of the object
+*	@param	width			Width of the object in mm
+*	@param	clearance		mm to keep between the robot and the object
+*	@param	side			Positive to pass the object on the left, negative on the right
+*	@param	speed			Speed in mm/s
+*	@return	1 if the detour started, 0 if the object is too close or too wide
+*	@date 10/17/2026
+*/
+uint8_t detour_start(int distance, int width, int clearance, int side, int speed)
+{
+	long around = width / 2 + clearance + ROBOT_RADIUS;
+	/// From the center of the robot to the center of the object
+	long reach = (long) distance + ROBOT_RADIUS + width / 2;
+	long radius;
+	int degrees;
+	uint8_t count = 0;
+
+	if (reach <= around || around > OI_RADIUS_MAX)
+		return 0;
+
+	/// Three arcs, tangent to each other: away from the path, around the
+	/// object centered on it, and back onto the path past it. The first and
+	/// last have the radius r with sqrt(reach^2 + r^2) = r + around.
+	radius = (reach * reach - around * around) / (2 * around);
+	/// A gentler swerve than the Create can drive starts closer, after a straight
+	if (radius > OI_RADIUS_MAX)
+	{
+		radius = OI_RADIUS_MAX;
+		reach = (long) sqrt((double) around * around + 2.0 * radius * around);
+		motion_plan[count].kind = MOTION_KIND_MOVE;
+		motion_plan[count].by_angle = 0;
+		motion_plan[count].radius = 0;
+		motion_plan[count].amount = (int) ((long) distance + ROBOT_RADIUS + width / 2 - reach);
+		count++;
+	}
+	degrees = (int) (atan2((double) reach, (double) radius) * 180.0 / M_PI + 0.5);
+	if (side < 0)
+		radius = -radius;
+
+	motion_plan[count].kind = MOTION_KIND_ARC;
+	motion_plan[count].by_angle = 1;
+	motion_plan[count].radius = (int16_t) radius;
+	motion_plan[count].amount = degrees;
+	count++;
+	motion_plan[count].kind = MOTION_KIND_ARC;
+	motion_plan[count].by_angle = 1;
+	motion_plan[count].radius = (int16_t) (side < 0 ? around : -around);
+	motion_plan[count].amount = 2 * degrees;
+	count++;
+	motion_plan[count] = motion_plan[count - 2];
+	count++;
+
+	motion_plan_start(count, speed);
+	return 1;
+}
+
+/**
+*	This method starts following the path set with pursuit_clear() and
+*	pursuit_add(), from where the robot is now
+*	@param	speed			Wheel speed on the straight parts in mm/s
+*	@return	1 if the path started, 0 if it has no points or is longer than
+*			PURSUIT_LENGTH_MAX, which ends the motion with MOTION_STOPPED
+*	@date 10/17/2026
+*/
+uint8_t path_start(int speed)
+{
+	long length;
+
+	if (!pursuit_points())
+		return 0;
+	length = pursuit_begin();
+	if (length < 0)
+	{
+		motion_finish(MOTION_STOPPED);
+		return 0;
+	}
+	motion_start(MOTION_KIND_PATH, (int) length, speed);
+	return 1;
+}
+
+/**
+*	This method stops the wheels and waits for the robot to come to rest
+*	before the motion ends
+*	@date 10/17/2026
+*/
+static void motion_stop(void)
+{
+	drive_set_now(0, 0);
+	motion_settling = 1;
+	motion_still = 0;
+	motion_stop_time = motion_frame_time;
+}
+
+/**
+*	This method ends a motion that came to rest. A turn learns from how far
+*	it overshot, so the next one at this speed ends that much earlier.
+*	@date 10/17/2026
+*/
+static void motion_settled(void)
+{
+	int8_t *overshoot;
+	int learned;
+
+	if (motion_kind == MOTION_KIND_TURN)
+	{
+		overshoot = &turn_overshoot[MIN(motion_plan_speed / TURN_BAND_WIDTH, TURN_BANDS - 1)];
+		/// Halfway toward the lead that would have hit the goal
+		learned = *overshoot + (motion_covered - motion_goal) / 2;
+		*overshoot = (int8_t) MAX(0, MIN(TURN_LEAD_MAX, learned));
+	}
+	motion_finish(MOTION_DONE);
+}
+
+/**
+*	This method handles a step that found no new frame. With no frames the
+*	wheels would keep the last speed they were sent and nothing would end
+*	the motion, so it stops once the frames are too late.
+*	@return	the state of the motion
+*	@date 10/17/2026
+*/
+static uint8_t motion_no_frame(void)
+{
+	if (motion_settling)
+	{
+		if (clock_ms() - motion_stop_time > MOTION_SETTLE_MS)
+			motion_settled();
+	}
+	else if (clock_ms() - motion_frame_time > MOTION_FRAME_TIMEOUT_MS)
+	{
+		motion_finish(MOTION_STOPPED);
+	}
+	return motion_state;
+}
+
+/**
+*	This method finds the speed that brings the motion to rest at its goal.
+*	It aims to reach creep speed MOTION_CREEP_DISTANCE short of the goal,
+*	allowing for the distance covered before the next step, and stops from
+*	creep speed so the robot comes to rest at the goal.
+*	@param	remaining		mm left to the goal; for turns, mm of wheel travel
+*	@return	the wheel speed to aim for in mm/s, or 0 once the robot was stopped
+*	@date 10/17/2026
+*/
+static int16_t motion_approach_speed(long remaining)
+{
+	int16_t speed = drive_speed();
+	int16_t target;
+	/// Distance covered before the next step can react
+	long lead = (long) speed * motion_poll_ms / 1000;
+
+	if (remaining <= 0 || (speed <= MOTION_CREEP_SPEED && remaining <= lead / 2 + MOTION_CREEP_COAST))
+	{
+		motion_stop();
+		return 0;
+	}
+
+	target = abs(motion_speed);
+	if (remaining - lead - MOTION_CREEP_DISTANCE < 0x7FFF)
+		target = MIN(target, MAX(MOTION_CREEP_SPEED, drive_approach_speed((int16_t) (remaining - lead - MOTION_CREEP_DISTANCE))));
+	return target;
+}
+
+/**
+*	This method brings a straight move or a turn to rest at its goal
+*	@param	angle			Degrees turned since the last step
+*	@param	elapsed			ms between the frames of this step and the last
+*	@param	remaining		mm left to the goal; for turns, mm of wheel travel
+*	@date 10/17/2026
+*/
+static void motion_approach(int16_t angle, uint16_t elapsed, long remaining)
+{
+	int16_t target = motion_approach_speed(remaining);
+	int16_t right, left;
+
+	if (!target)
+		return;
+	if (motion_speed < 0)
+		target = -target;
+	if (motion_kind == MOTION_KIND_TURN)
+	{
+		drive_set(target, -target);
+		return;
+	}
+	heading_trim(angle, elapsed, target, &right, &left);
+	drive_set(right, left);
+}
+
+/**
+*	This method advances the stepped motion by one sensor update
+*	@param	sensor			Instance of the robot, updated by this call
+*	@return	MOTION_IDLE, _RUNNING, _DONE, _STOPPED or _CANCELLED
+*	@date 10/17/2026
+*/
+uint8_t motion_step(oi_t *sensor)
+{
+	int16_t right, left, speed, distance, angle, elapsed;
+	long remaining;
+	uint8_t last;
+	oi_frame_t frame;
+
+	if (motion_state != MOTION_RUNNING)
+		return motion_state;
+
+	/// A streamed frame comes every 15 ms and oi_update_list() hands out the
+	/// same one until then; stepping on it again would act on no movement
+	if (oi_stream_active() && oi_frame_seq() == motion_seq)
+		return motion_no_frame();
+	oi_update_list(sensor, motion_packets, sizeof(motion_packets));
+	/// A poll that failed brought no frame either
+	if (oi_frame_copy(&frame) == motion_seq)
+		return motion_no_frame();
+	motion_seq = frame.seq;
+	distance = frame.distance_sum - motion_distance_sum;
+	angle = frame.angle_sum - motion_angle_sum;
+	motion_distance_sum = frame.distance_sum;
+	motion_angle_sum = frame.angle_sum;
+	last = motion_plan_next + 1 >= motion_plan_count;
+
+	/// How long the robot runs between two looks at the sensors, by the
+	/// frames' own times and not by how often this is called
+	elapsed = (int16_t) (frame.time_ms - motion_frame_time);
+	motion_poll_ms += (elapsed - motion_poll_ms) / 4;
+	motion_frame_time = frame.time_ms;
+
+	if (motion_kind == MOTION_KIND_TURN)
+	{
+		motion_covered += motion_speed < 0 ? -angle : angle;
+		/// A wheel moving d mm turns d * 360 / (pi * WHEEL_BASE) degrees, so
+		/// this is the wheel travel left, short by the learned overshoot
+		remaining = (long) (motion_goal - motion_lead - motion_covered) * 250 / 111;
+	}
+	else if (motion_kind == MOTION_KIND_ARC && motion_by_angle)
+	{
+		/// Forward to the left, or backwards to the right, turns counterclockwise
+		motion_covered += (motion_speed < 0) != (motion_radius < 0) ? -angle : angle;
+		/// Path left along the arc: degrees * pi / 180 * radius (71 / 4068 ~ pi / 180)
+		remaining = (long) (motion_goal - motion_covered) * abs(motion_radius) * 71 / 4068;
+	}
+	else if (motion_kind == MOTION_KIND_PATH)
+	{
+		/// Path left from the point of the path nearest the robot
+		remaining = pursuit_update();
+		motion_covered = motion_goal - (int) remaining;
+	}
+	else
+	{
+		motion_covered += motion_speed < 0 ? -distance : distance;
+		/// The cliff flags, not the signals, which read something on any floor
+		if (motion_kind == MOTION_KIND_CARE && (frame.data.bumper_left || frame.data.bumper_right
+			|| frame.data.cliff_frontleft || frame.data.cliff_frontright))
+		{
+			motion_finish(MOTION_STOPPED);
+			return motion_state;
+		}
+		remaining = motion_goal - motion_covered;
+	}
+
+	/// A stopped move ends once the robot is at rest, so the error is final
+	if (motion_settling)
+	{
+		motion_still = distance != 0 || angle != 0 ? 0 : motion_still + 1;
+		if (motion_still >= 2 || frame.time_ms - motion_stop_time > MOTION_SETTLE_MS)
+			motion_settled();
+	}
+	/// Paths steer toward the lookahead point, at a speed that also stops at the end
+	else if (motion_kind == MOTION_KIND_PATH)
+	{
+		speed = motion_approach_speed(remaining);
+		if (speed)
+		{
+			pursuit_steer(speed, &right, &left);
+			drive_set(right, left);
+		}
+	}
+	else if (last && motion_kind != MOTION_KIND_ARC)
+	{
+		motion_approach(angle, (uint16_t) elapsed, remaining);
+	}
+	else if (motion_covered >= motion_goal)
+	{
+		/// Go straight on to the next segment without stopping
+		if (!last)
+			motion_segment_start(&motion_plan[++motion_plan_next]);
+		else
+			motion_finish(MOTION_DONE);
+	}
+	/// Arcs slow down on their own toward the end of the plan
+	else if (motion_kind == MOTION_KIND_ARC)
+	{
+		speed = abs(motion_speed);
+		if (last && remaining < 0x7FFF && drive_approach_speed((int16_t) remaining) < speed)
+			speed = MAX(ARC_SPEED_MIN, drive_approach_speed((int16_t) remaining));
+		motion_arc_drive(motion_speed < 0 ? -speed : speed);
+	}
+	/// Straight moves steer back onto the heading they started with
+	else if (motion_kind != MOTION_KIND_TURN)
+	{
+		heading_trim(angle, (uint16_t) elapsed, motion_speed, &right, &left);
+		drive_set(right, left);
+	}
+	return motion_state;
+}
+
+/**
+*	This method returns the state of the stepped motion
+*	@return	MOTION_IDLE, _RUNNING, _DONE, _STOPPED or _CANCELLED
+*	@date 10/17/2026
+*/
+uint8_t motion_status(void)
+{
+	return motion_state;
+}
+
+/**
+*	This method returns how much of the stepped motion is left
+*	@return	mm or degrees still to go; negative after an overshoot
+*	@date 10/17/2026
+*/
+int motion_remaining(void)
+{
+	return motion_goal - motion_covered;
+}
+
+/**
+*	This method returns the speed of the stepped motion
+*	@return	mm/s it was started with, after the battery cap
+*	@date 10/17/2026
+*/
+int motion_cruise_speed(void)
+{
+	return motion_plan_speed;
+}
+
+/**
+*	This method stops the stepped motion early
+*	@date 10/17/2026
+*/
+void motion_cancel(void)
+{
+	if (motion_state == MOTION_RUNNING)
+		motion_finish(MOTION_CANCELLED);
+}
+
+/**
+*	This method waits for the next frame while the Create streams them, so
+*	the blocking motions sleep between frames instead of spinning. Polled
+*	frames are read by motion_step() itself.
+*	@date 10/17/2026
+*/
+static void motion_wait_frame(void)
+{
+	if (oi_stream_active())
+		oi_frame_wait(motion_seq, MOTION_FRAME_WAIT_MS);
+}
+
+/**
+*	This method moves the robot so many meters
+*	@author	Robert Guetzlaff
+*	@param	sensor			Instance of the robot
+*	@param	notcentimeters	Distance to move in meters
+*	@date 7/6/2016
+*/
+void move(oi_t *sensor, int notcentimeters)
+{
+	/// Full speed, ramped up by the speed profile
+	move_start(notcentimeters, 250);
+	while (motion_step(sensor) == MOTION_RUNNING)
+		motion_wait_frame();
+}
+
+/**
+*	This method moves the robot so many centimeters
+*	@author Nicus Hicks
+*	@param	sensor			Instance of the robot
+*	@param	distance		Distance to move in centimeters
+*	@date 7/6/2016
+*/
+int careMove(oi_t* sensor, int distance, int speed)
+{
+	care_move_start(distance, speed);
+	while (motion_step(sensor) == MOTION_RUNNING)
+		motion_wait_frame();
+	/// The distance still needed to travel
+	return motion_remaining(); 
+}
+
+/**
+*	This method turns the robot 
+*	@author Zach Newton and Nathan Francque
+*	@param	sensor			Instance of the robot
+*	@param	degrees			Degrees to turn. Positive for counterclockwise. Negative for clockwise
+*	@param	speed			Speed to turn to robot
+*	@date 7/6/2016
+*/
+void turn(oi_t *sensor, int degrees, int speed)
+{
+	turn_start(degrees, speed);
+	while (motion_step(sensor) == MOTION_RUNNING)
+	{
+		lprintf("%d", motion_goal - motion_remaining());
+		motion_wait_frame();
+	}
+}
+
+/**
+*	This method turns the robot to an absolute heading, the shorter way round
+*	@param	sensor			Instance of the robot
+*	@param	heading			Heading in degrees, counterclockwise positive
+*	@param	speed			Wheel speed in mm/s
+*	@date 10/17/2026
+*/
+void turn_to_heading(oi_t *sensor, int heading, int speed)
+{
+	turn_to_heading_start(heading, speed);
+	while (motion_step(sensor) == MOTION_RUNNING)
+		motion_wait_frame();
+}
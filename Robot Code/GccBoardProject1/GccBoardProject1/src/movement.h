@@ -1,40 +1,225 @@
-/**
-*	@file movement.h
-*	@brief this header file will contain all required
-*			definitions and basic movement functions.
-*	@author @author Robert Guetzlaff
-*	@date 7/5/2016
-*/
-
-#include "util.h"
-#include "lcd.h"
-#include "open_interface.h" 
-#include <avr/io.h>
-
-/**
-*	This method moves the robot so many meters
-*	@author Robert Guetzlaff
-*	@param	sensor			Instance of the robot
-*	@param	notcentimeters	Distance to move in meters
-*	@date 7/6/2016
-*/
-void move(oi_t *sensor, int notcentimeters);
-
-/**
-*	This method moves the robot so many centimeters
-*	@author Robert Guetzlaff
-*	@param	sensor			Instance of the robot
-*	@param	distance		Distance to move in centimeters
-*	@date 7/6/2016
-*/
-int careMove(oi_t* sensor, int distance, int speed);
-
-/**
-*	This method turns the robot
-*	@author Robert Guetzlaff
-*	@param	sensor			Instance of the robot
-*	@param	degrees			Degrees to turn. Positive for clockwise. Negative for counterclockwise
-*	@param	speed			Speed to turn to robot
-*	@date 7/6/2016
-*/
-void turn(oi_t *sensor, int degrees, int speed);
\ No newline at end of file
+/**
+*	@file movement.h
+*	@brief this header file will contain all required
+*			definitions and basic movement functions.
+*	@author @author Robert Guetzlaff
+*	@date 7/5/2016
+*/
+
+#include "util.h"
+#include "lcd.h"
+#include "open_interface.h" 
+#include <avr/io.h>
+
+/**
+*	This method moves the robot so many meters
+*	@author Robert Guetzlaff
+*	@param	sensor			Instance of the robot
+*	@param	notcentimeters	Distance to move in meters
+*	@date 7/6/2016
+*/
+void move(oi_t *sensor, int notcentimeters);
+
+/**
+*	This method moves the robot so many centimeters
+*	@author Robert Guetzlaff
+*	@param	sensor			Instance of the robot
+*	@param	distance		Distance to move in centimeters
+*	@date 7/6/2016
+*/
+int careMove(oi_t* sensor, int distance, int speed);
+
+/**
+*	This method turns the robot
+*	@author Robert Guetzlaff
+*	@param	sensor			Instance of the robot
+*	@param	degrees			Degrees to turn. Positive for counterclockwise. Negative for clockwise
+*	@param	speed			Speed to turn to robot
+*	@date 7/6/2016
+*/
+void turn(oi_t *sensor, int degrees, int speed);
+
+/**
+*	This method turns the robot to an absolute heading, the shorter way round.
+*	Turns learn their overshoot at each speed and end early by it.
+*	@param	sensor			Instance of the robot
+*	@param	heading			Heading in degrees, counterclockwise positive, as odometry keeps it
+*	@param	speed			Wheel speed in mm/s
+*	@date 10/17/2026
+*/
+void turn_to_heading(oi_t *sensor, int heading, int speed);
+
+/// Status of a stepped move or turn
+#define MOTION_IDLE			0
+#define MOTION_RUNNING		1
+#define MOTION_DONE			2
+#define MOTION_STOPPED		3	// a care move hit a bumper or a cliff, no frames came, or the speed was 0
+#define MOTION_CANCELLED	4
+
+/**
+*	This method starts a move that motion_step() then advances. move(),
+*	careMove() and turn() are the blocking versions. Only one stepped
+*	motion runs at a time; starting another replaces it.
+*	@param	millimeters		Distance to move. Negative moves backwards
+*	@param	speed			Wheel speed in mm/s
+*	@date 10/17/2026
+*/
+void move_start(int millimeters, int speed);
+
+/**
+*	This method starts a move that stops early for bumpers and cliffs
+*	@param	distance		Distance to move in mm. Negative moves backwards
+*	@param	speed			Wheel speed in mm/s
+*	@date 10/17/2026
+*/
+void care_move_start(int distance, int speed);
+
+/**
+*	This method starts a turn in place
+*	@param	degrees			Degrees to turn, same direction convention as turn()
+*	@param	speed			Wheel speed in mm/s
+*	@date 10/17/2026
+*/
+void turn_start(int degrees, int speed);
+
+/**
+*	This method starts a turn to an absolute heading, the shorter way round
+*	@param	heading			Heading in degrees, counterclockwise positive
+*	@param	speed			Wheel speed in mm/s
+*	@date 10/17/2026
+*/
+void turn_to_heading_start(int heading, int speed);
+
+/**
+*	This method starts an arc with the Create's radius drive. It ends on the
+*	path length measured by odometry and slows down before the end.
+*	@param	radius			mm to the center of the circle, positive to the left; 0 ends at once, MOTION_STOPPED
+*	@param	millimeters		Path length of the center of the robot. Negative backs up
+*	@param	speed			Speed in mm/s
+*	@date 10/17/2026
+*/
+void arc_start(int radius, int millimeters, int speed);
+
+/**
+*	This method starts a forward arc that ends on the change of heading
+*	@param	radius			mm to the center of the circle, positive to the left; 0 ends at once, MOTION_STOPPED
+*	@param	degrees			Change of heading
+*	@param	speed			Speed in mm/s
+*	@date 10/17/2026
+*/
+void arc_turn_start(int radius, int degrees, int speed);
+
+/**
+*	This method plans a detour around an object straight ahead as three
+*	tangent arcs: away from the path, around the object and back onto the
+*	path beyond it. The robot does not stop between them. A straight piece
+*	comes first when the swerve would be wider than the Create can drive.
+*	@param	distance		mm from the front of the robot to the near side of the
+*							object, as a scan measures it
+*	@param	width			Width of the object in mm
+*	@param	clearance		mm to keep between the robot and the object
+*	@param	side			Positive to pass the object on the left, negative on the right
+*	@param	speed			Speed in mm/s
+*	@return	1 if the detour started, 0 if the object is too close or too wide
+*	@date 10/17/2026
+*/
+uint8_t detour_start(int distance, int width, int clearance, int side, int speed);
+
+/**
+*	This method starts following a path with pure pursuit: the robot steers
+*	toward a point a lookahead distance further along and rounds the corners
+*	without stopping, slowing down on tight curves and at the end. Set the
+*	path with pursuit_clear() and pursuit_add() first.
+*	@param	speed			Wheel speed on the straight parts in mm/s
+*	@return	1 if the path started, 0 if it has no points or is longer than
+*			PURSUIT_LENGTH_MAX, which ends the motion with MOTION_STOPPED
+*	@date 10/17/2026
+*/
+uint8_t path_start(int speed);
+
+/**
+*	This method advances the stepped motion by one sensor update. Call it
+*	from the main loop between other work.
+*	@param	sensor			Instance of the robot, updated by this call
+*	@return	MOTION_IDLE, _RUNNING, _DONE, _STOPPED or _CANCELLED
+*	@date 10/17/2026
+*/
+uint8_t motion_step(oi_t *sensor);
+
+/**
+*	This method returns the state of the stepped motion
+*	@return	MOTION_IDLE, _RUNNING, _DONE, _STOPPED or _CANCELLED
+*	@date 10/17/2026
+*/
+uint8_t motion_status(void);
+
+/**
+*	This method returns how much of the stepped motion is left
+*	@return	mm or degrees still to go; negative after an overshoot
+*	@date 10/17/2026
+*/
+int motion_remaining(void);
+
+/**
+*	This method returns the speed of the stepped motion
+*	@return	mm/s it was started with, after the battery cap
+*	@date 10/17/2026
+*/
+int motion_cruise_speed(void);
+
+/**
+*	This method stops the stepped motion early
+*	@date 10/17/2026
+*/
+void motion_cancel(void);
+
+/// Status of a script driven move or turn
+#define MOTION_SCRIPT_IDLE		0
+#define MOTION_SCRIPT_RUNNING	1
+#define MOTION_SCRIPT_DONE		2
+#define MOTION_SCRIPT_ABORTED	3
+
+/**
+*	This method starts a move that the Create finishes on its own with a script.
+*	The robot keeps moving while the caller scans or talks to the host; call
+*	motion_script_poll() to follow it. Uses the requested velocity packets
+*	(41, 42) and the bumpers, so they should be part of the sensor stream.
+*	@param	millimeters		Distance to move. Negative moves backwards
+*	@param	speed			Wheel speed in mm/s
+*	@param	done			Called with MOTION_SCRIPT_DONE or MOTION_SCRIPT_ABORTED
+*							when the move ends; may be 0
+*	@date 10/17/2026
+*/
+void move_script_start(int millimeters, int speed, void (*done)(uint8_t status));
+
+/**
+*	This method starts a turn that the Create finishes on its own with a script.
+*	@param	degrees			Degrees to turn, same direction convention as turn()
+*	@param	speed			Wheel speed in mm/s
+*	@param	done			Called when the turn ends; may be 0
+*	@date 10/17/2026
+*/
+void turn_script_start(int degrees, int speed, void (*done)(uint8_t status));
+
+/**
+*	This method checks on a script driven move or turn. It aborts the
+*	script when a bumper is hit.
+*	@param	sensor			Instance of the robot, updated by this call
+*	@return	MOTION_SCRIPT_IDLE, _RUNNING, _DONE or _ABORTED
+*	@date 10/17/2026
+*/
+uint8_t motion_script_poll(oi_t *sensor);
+
+/**
+*	This method returns the state of the script driven move or turn without
+*	reading the sensors
+*	@return	MOTION_SCRIPT_IDLE, _RUNNING, _DONE or _ABORTED
+*	@date 10/17/2026
+*/
+uint8_t motion_script_status(void);
+
+/**
+*	This method stops a script driven move or turn early
+*	@date 10/17/2026
+*/
+void motion_script_abort(void);
\ No newline at end of file
@@ -0,0 +1,157 @@
+/**
+*	@file	odometry.c
+*	@brief	Dead reckoning from the Create's distance and angle sensors,
+*			using Q-format fixed point and a sine table instead of soft-float.
+*	@date	10/17/2026
+*/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "odometry.h"
+
+/// sin() of the first quarter turn in 64 steps, Q14
+static const int16_t odom_sin_table[65] PROGMEM = {
+	0, 402, 804, 1205, 1606, 2006, 2404, 2801,
+	3196, 3590, 3981, 4370, 4756, 5139, 5520, 5897,
+	6270, 6639, 7005, 7366, 7723, 8076, 8423, 8765,
+	9102, 9434, 9760, 10080, 10394, 10702, 11003, 11297,
+	11585, 11866, 12140, 12406, 12665, 12916, 13160, 13395,
+	13623, 13842, 14053, 14256, 14449, 14635, 14811, 14978,
+	15137, 15286, 15426, 15557, 15679, 15791, 15893, 15986,
+	16069, 16143, 16207, 16261, 16305, 16340, 16364, 16379,
+	16384
+};
+
+/// Current pose; written by odom_update(), which may run in the receive interrupt
+static odom_pose_t odom_pose;
+
+/**
+*	This method looks up sin() within the first quarter turn
+*	@param	position	Angle from 0 to ODOM_QUARTER_TURN
+*	@return	sine in Q14, interpolated between table entries
+*	@date	10/17/2026
+*/
+static int16_t odom_sin_quarter(uint16_t position)
+{
+	uint8_t i = position >> 8;
+	uint8_t fraction = position & 0xFF;
+	int16_t low = pgm_read_word(&odom_sin_table[i]);
+	int16_t high;
+
+	if (i == 64)
+		return low;
+	high = pgm_read_word(&odom_sin_table[i + 1]);
+	return low + (int16_t) (((int32_t) (high - low) * fraction) >> 8);
+}
+
+/**
+*	This method returns the sine of a binary angle
+*	@param	angle	Binary angle, 65536 = 360 degrees
+*	@return	sine in Q14
+*	@date	10/17/2026
+*/
+int16_t odom_sin(uint16_t angle)
+{
+	uint16_t position = angle & (ODOM_QUARTER_TURN - 1);
+	int16_t value;
+
+	/// The second and fourth quarters mirror the first
+	if (angle & ODOM_QUARTER_TURN)
+		position = ODOM_QUARTER_TURN - position;
+	value = odom_sin_quarter(position);
+
+	/// The second half turn is negative
+	return (angle & 0x8000) ? -value : value;
+}
+
+/**
+*	This method returns the cosine of a binary angle
+*	@param	angle	Binary angle, 65536 = 360 degrees
+*	@return	cosine in Q14
+*	@date	10/17/2026
+*/
+int16_t odom_cos(uint16_t angle)
+{
+	return odom_sin(angle + ODOM_QUARTER_TURN);
+}
+
+/**
+*	This method converts degrees to a binary angle
+*	@param	degrees		Angle in degrees, any number of turns
+*	@return	binary angle, 65536 = 360 degrees
+*	@date	10/17/2026
+*/
+uint16_t odom_deg_to_angle(int16_t degrees)
+{
+	/// Down to -180 .. 179 first, where degrees * 182 still fits an int
+	degrees %= 360;
+	if (degrees >= 180)
+		degrees -= 360;
+	else if (degrees < -180)
+		degrees += 360;
+	/// 65536 / 360 = 182 + 2913 / 65536
+	return (uint16_t) (degrees * 182 + (((int32_t) degrees * 2913 + 32768) >> 16));
+}
+
+/**
+*	This method converts a binary angle to degrees
+*	@param	angle	Binary angle, 65536 = 360 degrees
+*	@return	degrees from -180 to 180, rounded
+*	@date	10/17/2026
+*/
+int16_t odom_angle_to_deg(uint16_t angle)
+{
+	return (int16_t) (((int32_t) (int16_t) angle * 360 + 32768) >> 16);
+}
+
+/**
+*	This method sets the pose
+*	@param	x_mm			x coordinate in mm
+*	@param	y_mm			y coordinate in mm
+*	@param	heading_deg		Heading in degrees, counterclockwise positive
+*	@date	10/17/2026
+*/
+void odom_reset(int16_t x_mm, int16_t y_mm, int16_t heading_deg)
+{
+	uint8_t sreg = SREG;
+	cli();
+	odom_pose.x = (int32_t) x_mm << ODOM_Q;
+	odom_pose.y = (int32_t) y_mm << ODOM_Q;
+	odom_pose.heading = odom_deg_to_angle(heading_deg);
+	SREG = sreg;
+}
+
+/**
+*	This method folds one sensor frame into the pose
+*	@param	distance	mm driven since the previous frame
+*	@param	angle		Degrees turned since the previous frame
+*	@date	10/17/2026
+*/
+void odom_update(int16_t distance, int16_t angle)
+{
+	uint16_t turn = odom_deg_to_angle(angle);
+	/// Driving and turning happen together, so use the heading halfway through
+	uint16_t middle = odom_pose.heading + (int16_t) turn / 2;
+
+	if (distance != 0)
+	{
+		/// mm * Q14 >> 6 = mm in Q8
+		odom_pose.x += ((int32_t) distance * odom_cos(middle)) >> (ODOM_TRIG_Q - ODOM_Q);
+		odom_pose.y += ((int32_t) distance * odom_sin(middle)) >> (ODOM_TRIG_Q - ODOM_Q);
+	}
+	odom_pose.heading += turn;
+}
+
+/**
+*	This method copies the current pose
+*	@param	pose	Where to copy the pose
+*	@date	10/17/2026
+*/
+void odom_get(odom_pose_t *pose)
+{
+	uint8_t sreg = SREG;
+	cli();
+	*pose = odom_pose;
+	SREG = sreg;
+}
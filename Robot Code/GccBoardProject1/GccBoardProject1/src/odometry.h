@@ -0,0 +1,58 @@
+/**
+*	@file	odometry.h
+*	@brief	Fixed-point pose (x, y, heading) of the robot, integrated from the
+*			distance and angle of every sensor frame.
+*	@date	10/17/2026
+*/
+
+#ifndef ODOMETRY_H
+#define ODOMETRY_H
+
+#include <inttypes.h>
+
+/// Fractional bits of the x and y coordinates (Q8, 1/256 mm)
+#define ODOM_Q 8
+/// Fractional bits of odom_sin() and odom_cos() (Q14, 16384 = 1.0)
+#define ODOM_TRIG_Q 14
+/// Binary angle of a quarter turn; a full turn is 65536 and wraps on its own
+#define ODOM_QUARTER_TURN 0x4000
+
+/// Convert an x or y coordinate to whole millimeters
+#define ODOM_MM(q) ((int16_t) ((q) >> ODOM_Q))
+
+/// Pose of the robot relative to where odometry was last reset
+typedef struct {
+	int32_t x;        // mm in Q8, along the starting direction
+	int32_t y;        // mm in Q8, to the left of the starting direction
+	uint16_t heading; // binary angle, 65536 = 360 degrees, counterclockwise positive
+} odom_pose_t;
+
+/// \brief Set the pose, e.g. when the robot is placed at a known spot
+/// \param x_mm x coordinate in mm
+/// \param y_mm y coordinate in mm
+/// \param heading_deg heading in degrees, counterclockwise positive
+void odom_reset(int16_t x_mm, int16_t y_mm, int16_t heading_deg);
+
+/// \brief Fold one sensor frame into the pose. Called for every frame by the
+/// sensor receive path, so it must stay cheap (no floating point).
+/// \param distance mm driven since the previous frame
+/// \param angle degrees turned since the previous frame, counterclockwise positive
+void odom_update(int16_t distance, int16_t angle);
+
+/// \brief Copy the current pose
+/// \param pose where to copy it
+void odom_get(odom_pose_t *pose);
+
+/// \return sine of a binary angle in Q14, from a lookup table
+int16_t odom_sin(uint16_t angle);
+
+/// \return cosine of a binary angle in Q14, from a lookup table
+int16_t odom_cos(uint16_t angle);
+
+/// \return binary angle for any number of degrees, taken modulo 360
+uint16_t odom_deg_to_angle(int16_t degrees);
+
+/// \return a binary angle as degrees in the range -180 to 180, rounded
+int16_t odom_angle_to_deg(uint16_t angle);
+
+#endif
@@ -1,183 +1,1230 @@
-/**
-*	@file	open_interface.c
-*	@brief	API to communicate with Robot
-*	@author Robert Guetzlaff
-*	@date	7/6/2016
-*/
-
-#include <stdlib.h>
-#include "util.h"
-#include "open_interface.h"
-
-/// Allocate memory for a the sensor data
-oi_t* oi_alloc() 
-{
-	return calloc(1, sizeof(oi_t));
-}
-
-/// Free memory from a pointer to the sensor data struct
-void oi_free(oi_t *self) 
-{
-	free(self);
-}
-
-/// Initialize the Create
-void oi_init(oi_t *self) 
-{
-	// Setup USART1 to communicate to the iRobot Create using serial (baud = 57600)
-	UBRR1L = 16; // UBRR = (FOSC/16/BAUD-1);
-	UCSR1B = (1 << RXEN) | (1 << TXEN);
-	UCSR1C = (3 << UCSZ10);
-
-	// Starts the SCI. Must be sent first
-	oi_byte_tx(OI_OPCODE_START);
-	oi_byte_tx(OI_OPCODE_BAUD);
-
-	oi_byte_tx(8); // baud code for 28800
-	wait_ms(100);
-	
-	// Set the baud rate on the Cerebot II to match the Create's baud
-	UBRR1L = 33; // UBRR = (FOSC/16/BAUD-1);
-
-	// Use Full mode, unrestricted control
-	oi_byte_tx(OI_OPCODE_FULL);
-	oi_set_leds(1, 1, 7, 255);
-	
-	oi_update(self);
-	oi_update(self); // call twice to clear distance/angle
-}
-
-/// Update the Create. This will update all the sensor data and store it in the oi_t struct.
-void oi_update(oi_t *self) 
-{
-	int i;
-
-	// Clear the receive buffer
-	while (UCSR1A & (1 << RXC)) 
-		i = UDR1;
-
-	// Query a list of sensor values
-	oi_byte_tx(OI_OPCODE_SENSORS);
-	// Send the sensor packet ID
-	oi_byte_tx(OI_SENSOR_PACKET_GROUP6); 
-
-	// Read all the sensor data
-	char *sensor = (char *) self;
-	for (i = 0; i < 52; i++) 
-	{
-		// read each sensor byte
-		*(sensor++) = oi_byte_rx();
-	}
-	
-	sensor = (char *) self;
-	
-	// Fix byte ordering for multi-byte members of the struct
-	self->distance                 = (sensor[12] << 8) + sensor[13];
-	self->angle                    = (sensor[14] << 8) + sensor[15];
-	self->voltage                  = (sensor[17] << 8) + sensor[18];
-	self->current                  = (sensor[19] << 8) + sensor[20];
-	self->charge                   = (sensor[22] << 8) + sensor[23];
-	self->capacity                 = (sensor[24] << 8) + sensor[25];
-	self->wall_signal              = (sensor[26] << 8) + sensor[27];
-	self->cliff_left_signal        = (sensor[28] << 8) + sensor[29];
-	self->cliff_frontleft_signal   = (sensor[30] << 8) + sensor[31]; 
-	self->cliff_frontright_signal  = (sensor[32] << 8) + sensor[33];
-	self->cliff_right_signal       = (sensor[34] << 8) + sensor[35];
-	self->cargo_bay_voltage        = (sensor[41] << 8) + sensor[42];
-	self->requested_velocity       = (sensor[48] << 8) + sensor[42];
-	self->requested_radius         = (sensor[50] << 8) + sensor[51];
-	self->requested_right_velocity = (sensor[52] << 8) + sensor[53];
-	self->requested_left_velocity  = (sensor[54] << 8) + sensor[55];
-	
-	wait_ms(35); // reduces USART errors that occur when continuously transmitting/receiving
-}
-
-/// Sets the LEDs on the iRobot.
-/**
-* Set the state of the three LEDs on the iRobot (Power, Play, Advance).
-* @play_led        uint8_t either 0 (off) or 1 (on)
-* @advance_led     uint8_t either 0 (off) or 1 (on)
-* @power_color     uint8_t the color of the power LED; 0 = green, 255 = red
-* @power_intensity uint8_t the intensity of the power LED; 0 = off, 255 = full intensity
-*/
-void oi_set_leds(uint8_t play_led, uint8_t advance_led, uint8_t power_color, uint8_t power_intensity) 
-{
-	// LED Opcode
-	oi_byte_tx(OI_OPCODE_LEDS);
-
-	// Set the Play and Advance LEDs
-	oi_byte_tx(advance_led << 3 && play_led << 2);
-
-	// Set the power led color
-	oi_byte_tx(power_color);
-
-	// Set the power led intensity
-	oi_byte_tx(power_intensity);
-}
-
-/// Drive wheels directly; speeds are in mm / sec
-void oi_set_wheels(int16_t right_wheel, int16_t left_wheel) 
-{
-	oi_byte_tx(OI_OPCODE_DRIVE_WHEELS);
-	oi_byte_tx(right_wheel>>8);
-	oi_byte_tx(right_wheel & 0xff);
-	oi_byte_tx(left_wheel>>8);
-	oi_byte_tx(left_wheel& 0xff);
-}
-
-/// Loads a song onto the iRobot Create
-/// song index, number of notes, notes aray, duration array
-void oi_load_song(int song_index, int num_notes, unsigned char *notes, unsigned char *duration) 
-{
-	int i;
-	oi_byte_tx(OI_OPCODE_SONG);
-	oi_byte_tx(song_index);
-	oi_byte_tx(num_notes);
-	for (i=0;i<num_notes;i++) {
-		oi_byte_tx(notes[i]);
-		oi_byte_tx(duration[i]);
-	}
-}
-
-/// Plays a given song; use oi_load_song(...) first
-void oi_play_song(int index)
-{
-	oi_byte_tx(OI_OPCODE_PLAY);
-	oi_byte_tx(index);
-}
-
-/// Runs default go charge program; robot will search for dock
-void go_charge(void) 
-{
-	char charging_state=0;
-	
-	//Calling demo that will cause Create to seek out home base
-	oi_byte_tx(OI_OPCODE_MAX);
-	oi_byte_tx(0x01);
-	
-	//Control is returned immediately, so need to check for docking status
-	DDRB &= ~0x80; //Setting pin7 to input
-	PORTB |= 0x80; //Setting pullup on pin7
-	
-	do {
-		charging_state = PINB >> 7;
-	} while (charging_state == 0);
-}
-
-// Transmit a byte of data over the serial connection to the Create
-void oi_byte_tx(unsigned char value) 
-{
-	// Wait until the transmit buffer is empty
-	while (!(UCSR1A & (1 << UDRE)));
-
-	UDR1 = value;
-}
-
-// Receive a byte of data from the Create serial connection. Blocks until a byte is received.
-unsigned char oi_byte_rx(void) 
-{
-	// wait until a byte is received (Receive Complete flag, RXC, is set)
-	while (!(UCSR1A & (1 << RXC)));
-
-	return UDR1;
-}
+/**
+*	@file	open_interface.c
+*	@brief	API to communicate with Robot
+*	@author Robert Guetzlaff
+*	@date	7/6/2016
+*/
+
+#include <stdlib.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <avr/sleep.h>
+#include "util.h"
+#include "open_interface.h"
+#include "odometry.h"
+#include "drive.h"
+#include "safety.h"
+
+/// Packet descriptor flags
+#define OI_PACKET_SIGNED 0x01 // two's complement value
+#define OI_PACKET_SUM    0x02 // change since the last read; summed until the caller clears it
+
+/// How one sensor packet is stored in oi_t
+typedef struct {
+	uint8_t offset; // byte offset of the field in the packed oi_t
+	uint8_t width;  // bytes sent by the Create, high byte first
+	uint8_t flags;  // OI_PACKET_SIGNED, OI_PACKET_SUM
+	uint8_t mask;   // bits used by a bitfield packet, 0xFF for plain values
+} oi_packet_desc_t;
+
+/// Descriptor of every sensor packet, indexed by packet ID - 7
+static const oi_packet_desc_t oi_packets[] PROGMEM = {
+	{ 0, 1, 0, 0x1F},                              // 7  bumps and wheel drops
+	{ 1, 1, 0, 0xFF},                              // 8  wall
+	{ 2, 1, 0, 0xFF},                              // 9  cliff left
+	{ 3, 1, 0, 0xFF},                              // 10 cliff front left
+	{ 4, 1, 0, 0xFF},                              // 11 cliff front right
+	{ 5, 1, 0, 0xFF},                              // 12 cliff right
+	{ 6, 1, 0, 0xFF},                              // 13 virtual wall
+	{ 7, 1, 0, 0x1F},                              // 14 overcurrents
+	{ 8, 1, 0, 0xFF},                              // 15 unused
+	{ 9, 1, 0, 0xFF},                              // 16 unused
+	{10, 1, 0, 0xFF},                              // 17 infrared byte
+	{11, 1, 0, 0x05},                              // 18 buttons (play bit 0, advance bit 2)
+	{12, 2, OI_PACKET_SIGNED | OI_PACKET_SUM, 0xFF}, // 19 distance
+	{14, 2, OI_PACKET_SIGNED | OI_PACKET_SUM, 0xFF}, // 20 angle
+	{16, 1, 0, 0xFF},                              // 21 charging state
+	{17, 2, 0, 0xFF},                              // 22 voltage
+	{19, 2, OI_PACKET_SIGNED, 0xFF},               // 23 current
+	{21, 1, OI_PACKET_SIGNED, 0xFF},               // 24 temperature
+	{22, 2, 0, 0xFF},                              // 25 charge
+	{24, 2, 0, 0xFF},                              // 26 capacity
+	{26, 2, 0, 0xFF},                              // 27 wall signal
+	{28, 2, 0, 0xFF},                              // 28 cliff left signal
+	{30, 2, 0, 0xFF},                              // 29 cliff front left signal
+	{32, 2, 0, 0xFF},                              // 30 cliff front right signal
+	{34, 2, 0, 0xFF},                              // 31 cliff right signal
+	{36, 1, 0, 0x1F},                              // 32 cargo bay digital inputs
+	{37, 2, 0, 0xFF},                              // 33 cargo bay analog signal
+	{39, 1, 0, 0x03},                              // 34 charging sources available
+	{40, 1, 0, 0xFF},                              // 35 OI mode
+	{41, 1, 0, 0xFF},                              // 36 song number
+	{42, 1, 0, 0xFF},                              // 37 song playing
+	{43, 1, 0, 0xFF},                              // 38 number of stream packets
+	{44, 2, OI_PACKET_SIGNED, 0xFF},               // 39 requested velocity
+	{46, 2, OI_PACKET_SIGNED, 0xFF},               // 40 requested radius
+	{48, 2, OI_PACKET_SIGNED, 0xFF},               // 41 requested right velocity
+	{50, 2, OI_PACKET_SIGNED, 0xFF}                // 42 requested left velocity
+};
+
+/// First packet ID, last packet ID and data size of each sensor group
+static const uint8_t oi_groups[][3] PROGMEM = {
+	{ 7, 26, 26},
+	{ 7, 16, 10},
+	{17, 20,  6},
+	{21, 26, 10},
+	{27, 34, 14},
+	{35, 42, 12},
+	{ 7, 42, 52}
+};
+
+/// USART1 setting for each supported Create baud code
+typedef struct {
+	uint8_t baud_code;
+	uint8_t ubrr;  // with U2X set: rate = FOSC / 8 / (UBRR + 1)
+} oi_baud_t;
+
+/// Double speed mode keeps every rate within 2.1% of nominal at 16 MHz
+static const oi_baud_t oi_bauds[] = {
+	{OI_BAUD_28800,  68},  // 28986, +0.6%
+	{OI_BAUD_38400,  51},  // 38462, +0.2%
+	{OI_BAUD_57600,  34},  // 57143, -0.8%
+	{OI_BAUD_115200, 16}   // 117647, +2.1%
+};
+
+/// Packets read back to validate the link: OI mode (1-3) and the two unused packets (0)
+static const uint8_t oi_link_packets[] = {OI_SENSOR_OI_MODE, 15, 16};
+
+/// Link rate and error counts
+static oi_link_t oi_link_state;
+
+/// Largest stream frame (length byte) the receive interrupt will buffer
+#define OI_STREAM_FRAME_MAX 64
+
+/// Stream parser states
+#define OI_STREAM_WAIT_HEADER 0
+#define OI_STREAM_WAIT_LENGTH 1
+#define OI_STREAM_WAIT_DATA   2
+#define OI_STREAM_WAIT_CHECK  3
+
+/// Set while the Create is streaming sensor data to the receive interrupt
+static volatile uint8_t oi_streaming = 0;
+/// Double buffered sensor frames; oi_frame_front is the newest complete one
+static volatile oi_frame_t oi_frames[2];
+static volatile uint8_t oi_frame_front = 0;
+/// distance_sum and angle_sum of the frame last returned by oi_update()
+static int16_t oi_update_distance_sum = 0;
+static int16_t oi_update_angle_sum = 0;
+
+/// Packet list of the running stream, so it can be resumed after docking
+static const uint8_t *oi_stream_ids;
+static uint8_t oi_stream_count;
+
+/// Docking progress
+static oi_dock_t oi_dock_state;
+static unsigned long oi_dock_started;
+static unsigned long oi_dock_timeout;
+static uint8_t oi_dock_streamed = 0; // the stream was running when docking started
+/// Packets read while docking: bumps, IR byte, charging state and sources, mode
+static const uint8_t oi_dock_packets[] = {
+	OI_SENSOR_BUMPS_WHEELDROPS,
+	OI_SENSOR_INFRARED_BYTE,
+	OI_SENSOR_CHARGING_STATE,
+	OI_SENSOR_CHARGING_SOURCES,
+	OI_SENSOR_OI_MODE
+};
+
+/// Receive interrupt parser state
+static uint8_t oi_stream_state = OI_STREAM_WAIT_HEADER;
+static uint8_t oi_stream_length;
+static uint8_t oi_stream_index;
+static uint8_t oi_stream_checksum;
+/// Length byte of the frames requested by oi_stream_start()
+static uint8_t oi_stream_expected;
+/// One extra byte so oi_stream_rescan() can append the checksum
+static uint8_t oi_stream_frame[OI_STREAM_FRAME_MAX + 1];
+
+/// oi_byte_rx_timeout() results that are not data
+#define OI_RX_TIMEOUT (-1)
+#define OI_RX_ERROR   (-2)
+/// Longest gap between two bytes of a polled reply
+#define OI_RX_TIMEOUT_MS 20
+/// Polled queries are sent at most this many times per update
+#define OI_POLL_ATTEMPTS 2
+
+/// USART1 transmit queue, drained by the data register empty interrupt
+static volatile uint8_t oi_tx_buffer[OI_TX_BUFFER_SIZE];
+static volatile uint8_t oi_tx_head = 0; // next free slot, only written by oi_byte_tx()
+static volatile uint8_t oi_tx_tail = 0; // next byte to send, only written while sending
+/// Set once a byte was written to UDR1 and not yet waited for by oi_tx_flush()
+static volatile uint8_t oi_tx_pending = 0;
+
+/// Last wheel command sent, and one held back by the rate limit
+static int16_t oi_wheels_sent[2];
+static int16_t oi_wheels_waiting[2];
+static uint8_t oi_wheels_known = 0;   // oi_wheels_sent is what the Create is doing
+static uint8_t oi_wheels_held = 0;    // oi_wheels_waiting must still be sent
+static unsigned long oi_wheels_time;  // clock_ms() of the last command sent
+static unsigned int oi_wheels_interval = OI_WHEELS_INTERVAL_DEFAULT;
+
+/// Number of sensor data bytes sent for a packet or group ID
+uint8_t oi_packet_size(uint8_t packet_id)
+{
+	if (packet_id <= OI_SENSOR_PACKET_GROUP6)
+		return pgm_read_byte(&oi_groups[packet_id][2]);
+	if (packet_id <= OI_SENSOR_PACKET_MAX)
+		return pgm_read_byte(&oi_packets[packet_id - OI_SENSOR_BUMPS_WHEELDROPS].width);
+	return 0;
+}
+
+/// Decode the data of one packet or group ID into the sensor struct
+/**
+* Every packet is unpacked in a single pass from its descriptor in oi_packets[].
+* Values arrive high byte first. OI_PACKET_SUM fields (distance, angle) are
+* added to the value already in the struct, so the caller clears them when a
+* new reading period starts.
+* @self      oi_t struct to fill
+* @packet_id packet (7-42) or group (0-6) ID
+* @data      sensor bytes as received from the Create
+*/
+static void oi_decode(oi_t *self, uint8_t packet_id, const uint8_t *data)
+{
+	uint8_t *sensor = (uint8_t *) self;
+	const oi_packet_desc_t *desc;
+	uint8_t last = packet_id;
+	uint8_t offset, flags;
+	int16_t value;
+
+	if (packet_id <= OI_SENSOR_PACKET_GROUP6)
+	{
+		last = pgm_read_byte(&oi_groups[packet_id][1]);
+		packet_id = pgm_read_byte(&oi_groups[packet_id][0]);
+	}
+
+	for (desc = &oi_packets[packet_id - OI_SENSOR_BUMPS_WHEELDROPS]; packet_id <= last; packet_id++, desc++)
+	{
+		offset = pgm_read_byte(&desc->offset);
+		flags = pgm_read_byte(&desc->flags);
+
+		if (pgm_read_byte(&desc->width) == 2)
+		{
+			value = (data[0] << 8) | data[1];
+			data += 2;
+		}
+		else
+		{
+			// Single byte fields and bitfields are stored as they are sent
+			sensor[offset] = *(data++) & pgm_read_byte(&desc->mask);
+			continue;
+		}
+
+		if (flags & OI_PACKET_SUM)
+			value += *(int16_t *) &sensor[offset];
+		*(int16_t *) &sensor[offset] = value;
+	}
+}
+
+/// Start a new frame in the back buffer
+/**
+* The back buffer starts as a copy of the newest frame, so packets that are
+* not part of the update keep their values, and distance and angle start at 0.
+* Only one context may fill frames at a time: the receive interrupt while
+* streaming, the polled updates otherwise.
+* @return sensor data of the back buffer
+*/
+static oi_t *oi_frame_begin(void)
+{
+	oi_frame_t *back = (oi_frame_t *) &oi_frames[oi_frame_front ^ 1];
+
+	back->data = ((oi_frame_t *) &oi_frames[oi_frame_front])->data;
+	back->data.distance = 0;
+	back->data.angle = 0;
+	return &back->data;
+}
+
+/// Publish the back buffer as the newest frame
+static void oi_frame_end(void)
+{
+	oi_frame_t *front = (oi_frame_t *) &oi_frames[oi_frame_front];
+	oi_frame_t *back = (oi_frame_t *) &oi_frames[oi_frame_front ^ 1];
+
+	back->distance_sum = front->distance_sum + back->data.distance;
+	back->angle_sum = front->angle_sum + back->data.angle;
+	back->time_ms = clock_ms();
+	back->seq = front->seq + 1;
+
+	// Every frame moves the odometry pose
+	odom_update(back->data.distance, back->data.angle);
+	// and is checked for hazards, whatever the main loop is doing
+	safety_check(&back->data, back->time_ms);
+
+	// A single byte write, so readers always see one complete frame or the other
+	oi_frame_front ^= 1;
+}
+
+/// Decode a stream frame that passed its checksum and publish it
+static void oi_stream_decode(void)
+{
+	oi_t *data = oi_frame_begin();
+	uint8_t i = 0;
+	uint8_t id;
+
+	while (i < oi_stream_length)
+	{
+		id = oi_stream_frame[i++];
+		if (oi_packet_size(id) == 0 || i + oi_packet_size(id) > oi_stream_length)
+			break;
+		oi_decode(data, id, &oi_stream_frame[i]);
+		i += oi_packet_size(id);
+	}
+
+	oi_frame_end();
+}
+
+/// Counts the receive errors flagged in a UCSR1A value
+/**
+* @return nonzero if the byte read with this status is not valid
+*/
+static uint8_t oi_rx_errors(uint8_t status)
+{
+	if (status & (1 << FE))
+		oi_link_state.framing_errors++;
+	if (status & (1 << DOR))
+		oi_link_state.overruns++;
+	if (status & (1 << UPE))
+		oi_link_state.parity_errors++;
+	return status & ((1 << FE) | (1 << DOR) | (1 << UPE));
+}
+
+/// After a bad checksum, looks for the next header among the bytes received
+/**
+* The header that started the bad frame may have been a data byte, in which 
+* case the real header is somewhere in the buffer. Anything after it is moved
+* to the front so the next frame is not lost as well.
+* @param last the checksum byte, which is not in oi_stream_frame yet
+*/
+static void oi_stream_rescan(uint8_t last)
+{
+	uint8_t i, k;
+
+	oi_stream_frame[oi_stream_length] = last;
+	for (k = 0; k <= oi_stream_length; k++)
+	{
+		if (oi_stream_frame[k] != OI_STREAM_HEADER)
+			continue;
+		if (k == oi_stream_length)
+		{
+			oi_stream_checksum = OI_STREAM_HEADER;
+			oi_stream_state = OI_STREAM_WAIT_LENGTH;
+			return;
+		}
+		if (oi_stream_frame[k + 1] != oi_stream_expected)
+			continue;
+
+		// Fewer than oi_stream_length bytes are left, so the frame is still open
+		oi_stream_checksum = OI_STREAM_HEADER + oi_stream_expected;
+		oi_stream_index = 0;
+		for (i = k + 2; i <= oi_stream_length; i++)
+		{
+			oi_stream_checksum += oi_stream_frame[i];
+			oi_stream_frame[oi_stream_index++] = oi_stream_frame[i];
+		}
+		oi_stream_state = OI_STREAM_WAIT_DATA;
+		return;
+	}
+	oi_stream_state = OI_STREAM_WAIT_HEADER;
+}
+
+/// USART1 receive interrupt; parses the Create's sensor stream one byte at a time
+/**
+* Frames look like [19][n][packet id][data]...[checksum], where the 8-bit sum
+* of every byte in the frame including the checksum is 0.
+*/
+ISR (USART1_RX_vect)
+{
+	uint8_t status = UCSR1A;
+	uint8_t value = UDR1;
+
+	// A framing, overrun or parity error means the current frame is lost
+	if (oi_rx_errors(status))
+	{
+		if (oi_stream_state != OI_STREAM_WAIT_HEADER)
+			oi_link_state.frames_dropped++;
+		oi_stream_state = OI_STREAM_WAIT_HEADER;
+		return;
+	}
+
+	switch (oi_stream_state)
+	{
+		case OI_STREAM_WAIT_HEADER:
+			if (value == OI_STREAM_HEADER)
+			{
+				oi_stream_checksum = value;
+				oi_stream_state = OI_STREAM_WAIT_LENGTH;
+			}
+			break;
+		case OI_STREAM_WAIT_LENGTH:
+			// Every frame has the length that was requested, so anything else 
+			// means the header was really a data byte
+			if (value == oi_stream_expected)
+			{
+				oi_stream_checksum += value;
+				oi_stream_length = value;
+				oi_stream_index = 0;
+				oi_stream_state = OI_STREAM_WAIT_DATA;
+			}
+			else if (value != OI_STREAM_HEADER)
+				oi_stream_state = OI_STREAM_WAIT_HEADER;
+			break;
+		case OI_STREAM_WAIT_DATA:
+			oi_stream_checksum += value;
+			oi_stream_frame[oi_stream_index++] = value;
+			if (oi_stream_index == oi_stream_length)
+				oi_stream_state = OI_STREAM_WAIT_CHECK;
+			break;
+		case OI_STREAM_WAIT_CHECK:
+			oi_stream_checksum += value;
+			if (oi_stream_checksum == 0)
+			{
+				oi_stream_decode();
+				oi_link_state.frames_good++;
+				oi_stream_state = OI_STREAM_WAIT_HEADER;
+			}
+			else
+			{
+				oi_link_state.frames_corrupt++;
+				oi_stream_rescan(value);
+			}
+			break;
+	}
+}
+
+/// Allocate memory for a the sensor data
+oi_t* oi_alloc() 
+{
+	return calloc(1, sizeof(oi_t));
+}
+
+/// Free memory from a pointer to the sensor data struct
+void oi_free(oi_t *self) 
+{
+	free(self);
+}
+
+/// Set the USART1 rate for a Create baud code
+/**
+* @baud_code Create baud code
+* @return 1 if the code is supported, 0 otherwise (the rate is not changed)
+*/
+static uint8_t oi_usart_baud(uint8_t baud_code)
+{
+	uint8_t i;
+
+	for (i = 0; i < sizeof(oi_bauds) / sizeof(oi_bauds[0]); i++)
+	{
+		if (oi_bauds[i].baud_code != baud_code)
+			continue;
+
+		UBRR1H = 0;
+		UBRR1L = oi_bauds[i].ubrr;
+		// An assignment, so the error flags are not written back
+		UCSR1A = (1 << U2X);
+
+		oi_link_state.baud_code = baud_code;
+		oi_link_state.baud = FOSC / 8 / (oi_bauds[i].ubrr + 1);
+		// 10 bits per byte, 15 ms per frame
+		oi_link_state.stream_budget = MIN(oi_link_state.baud * 15 / 10000, 255);
+		return 1;
+	}
+	return 0;
+}
+
+/// Receive a byte, giving up after timeout_ms
+/**
+* @return the byte, or -1 on timeout or a framing, overrun or parity error
+*/
+static int16_t oi_byte_rx_timeout(unsigned int timeout_ms)
+{
+	unsigned long start = clock_ms();
+	uint8_t status;
+
+	while (!((status = UCSR1A) & (1 << RXC)))
+	{
+		if (clock_ms() - start >= timeout_ms)
+			return OI_RX_TIMEOUT;
+	}
+	if (oi_rx_errors(status))
+	{
+		status = UDR1;
+		return OI_RX_ERROR;
+	}
+	return UDR1;
+}
+
+/// Reads a polled reply of a known length
+/**
+* On failure, waits until the line is quiet so the rest of the reply cannot
+* be mistaken for the answer to the next query.
+* @param data buffer for the reply
+* @param length number of bytes expected
+* @return 1 if all bytes arrived without errors, 0 if the reply was dropped
+*/
+static uint8_t oi_rx_reply(uint8_t *data, uint8_t length)
+{
+	uint8_t i;
+	int16_t value;
+
+	for (i = 0; i < length; i++)
+	{
+		value = oi_byte_rx_timeout(OI_RX_TIMEOUT_MS);
+		if (value < 0)
+		{
+			oi_link_state.frames_dropped++;
+			while (oi_byte_rx_timeout(OI_RX_TIMEOUT_MS) != OI_RX_TIMEOUT)
+				;
+			return 0;
+		}
+		data[i] = value;
+	}
+	oi_link_state.frames_good++;
+	return 1;
+}
+
+/// Check the link by reading back packets with known values
+/**
+* @return 1 if the Create answered correctly at the current rate
+*/
+static uint8_t oi_link_check(void)
+{
+	int16_t value[sizeof(oi_link_packets)];
+	uint8_t i;
+
+	// Drop anything left over from the previous rate
+	while (UCSR1A & (1 << RXC))
+		i = UDR1;
+
+	oi_byte_tx(OI_OPCODE_QUERY_LIST);
+	oi_byte_tx(sizeof(oi_link_packets));
+	for (i = 0; i < sizeof(oi_link_packets); i++)
+		oi_byte_tx(oi_link_packets[i]);
+
+	for (i = 0; i < sizeof(oi_link_packets); i++)
+		value[i] = oi_byte_rx_timeout(50);
+
+	if (value[0] < 1 || value[0] > 3 || value[1] != 0 || value[2] != 0)
+	{
+		oi_link_state.check_errors++;
+		return 0;
+	}
+	return 1;
+}
+
+/// Switch the Create and the USART to a new rate; see open_interface.h
+uint8_t oi_set_baud(uint8_t baud_code)
+{
+	uint8_t old_code = oi_link_state.baud_code;
+	uint8_t i;
+
+	if (oi_streaming)
+		return 0;
+	for (i = 0; i < sizeof(oi_bauds) / sizeof(oi_bauds[0]); i++)
+	{
+		if (oi_bauds[i].baud_code == baud_code)
+			break;
+	}
+	if (i == sizeof(oi_bauds) / sizeof(oi_bauds[0]))
+		return 0;
+
+	oi_byte_tx(OI_OPCODE_BAUD);
+	oi_byte_tx(baud_code);
+	oi_tx_flush();
+	// The Create needs 100 ms before it accepts data at the new rate
+	wait_ms(100);
+
+	oi_usart_baud(baud_code);
+	if (oi_link_check())
+		return 1;
+
+	oi_link_state.baud_fallbacks++;
+
+	// The Create may have ignored the change
+	oi_usart_baud(old_code);
+	if (oi_link_check())
+		return 0;
+
+	// It switched, but the new rate is unusable: ask it to go back
+	oi_usart_baud(baud_code);
+	oi_byte_tx(OI_OPCODE_BAUD);
+	oi_byte_tx(old_code);
+	oi_tx_flush();
+	wait_ms(100);
+	oi_usart_baud(old_code);
+	oi_link_check();
+	return 0;
+}
+
+/// Link rate and error counts
+const oi_link_t *oi_link(void)
+{
+	return &oi_link_state;
+}
+
+/// Initialize the Create
+void oi_init(oi_t *self) 
+{
+	// Start with an empty transmit queue
+	oi_tx_head = 0;
+	oi_tx_tail = 0;
+	oi_wheels_invalidate();
+
+	// Setup USART1 to communicate to the iRobot Create using serial (baud = 57600)
+	oi_usart_baud(OI_BAUD_57600);
+	UCSR1B = (1 << RXEN) | (1 << TXEN);
+	UCSR1C = (3 << UCSZ10);
+
+	// Starts the SCI. Must be sent first
+	oi_byte_tx(OI_OPCODE_START);
+	oi_tx_flush();
+	wait_ms(20);
+
+	// Switch only if the build asked for another rate; if even 57600 does
+	// not validate, use 28800 like earlier firmware did
+	if (OI_BAUD_DEFAULT == OI_BAUD_57600 ? !oi_link_check() : !oi_set_baud(OI_BAUD_DEFAULT) && !oi_link_check())
+		oi_set_baud(OI_BAUD_28800);
+
+	// Use Full mode, unrestricted control
+	oi_byte_tx(OI_OPCODE_FULL);
+	oi_set_leds(1, 1, 7, 255);
+	
+	oi_update(self);
+	oi_update(self); // call twice to clear distance/angle
+}
+
+/// Send a wheel command the rate limit held back, if its time has come
+static void oi_wheels_service(void)
+{
+	// A hazard from the stream gets its stop before anything else goes out
+	safety_service();
+	// Let the speed profile take its next step first
+	drive_service();
+	if (oi_wheels_held && clock_ms() - oi_wheels_time >= oi_wheels_interval)
+		oi_wheels_flush();
+}
+
+/// Copy the newest frame into self, with distance and angle summed since the last call
+static void oi_update_frame(oi_t *self)
+{
+	oi_frame_t frame;
+
+	oi_frame_copy(&frame);
+	*self = frame.data;
+	self->distance = frame.distance_sum - oi_update_distance_sum;
+	self->angle = frame.angle_sum - oi_update_angle_sum;
+	oi_update_distance_sum = frame.distance_sum;
+	oi_update_angle_sum = frame.angle_sum;
+}
+
+/// Update the Create. This will update all the sensor data and store it in the oi_t struct.
+void oi_update(oi_t *self) 
+{
+	uint8_t sensor[52];
+	uint8_t attempt;
+
+	oi_wheels_service();
+
+	// While streaming, the receive interrupt already holds the newest data
+	if (oi_streaming)
+	{
+		oi_update_frame(self);
+		return;
+	}
+
+	for (attempt = 0; attempt < OI_POLL_ATTEMPTS; attempt++)
+	{
+		// Clear the receive buffer
+		while (UCSR1A & (1 << RXC)) 
+			sensor[0] = UDR1;
+
+		// Query a list of sensor values
+		oi_byte_tx(OI_OPCODE_SENSORS);
+		// Send the sensor packet ID
+		oi_byte_tx(OI_SENSOR_PACKET_GROUP6); 
+
+		// Read all the sensor data, then unpack it in one pass
+		if (oi_rx_reply(sensor, sizeof(sensor)))
+		{
+			oi_decode(oi_frame_begin(), OI_SENSOR_PACKET_GROUP6, sensor);
+			oi_frame_end();
+			// Polled frames come in on this thread, so a stop can go out at once
+			safety_service();
+			break;
+		}
+	}
+	oi_update_frame(self);
+}
+
+/// Update a list of sensor packets from the Create; see open_interface.h
+void oi_update_list(oi_t *self, const uint8_t *packet_ids, uint8_t num_packets)
+{
+	uint8_t data[OI_STREAM_FRAME_MAX];
+	uint8_t i, attempt;
+	uint16_t length = 0;
+	oi_t *frame;
+
+	if (oi_streaming)
+	{
+		oi_update(self);
+		return;
+	}
+	oi_wheels_service();
+
+	for (i = 0; i < num_packets; i++)
+		length += oi_packet_size(packet_ids[i]);
+	if (length > sizeof(data))
+		return;
+
+	for (attempt = 0; attempt < OI_POLL_ATTEMPTS; attempt++)
+	{
+		// Clear the receive buffer
+		while (UCSR1A & (1 << RXC)) 
+			data[0] = UDR1;
+
+		oi_byte_tx(OI_OPCODE_QUERY_LIST);
+		oi_byte_tx(num_packets);
+		for (i = 0; i < num_packets; i++)
+			oi_byte_tx(packet_ids[i]);
+
+		// The Create answers with the data of each packet in order, without IDs
+		if (oi_rx_reply(data, length))
+		{
+			frame = oi_frame_begin();
+			length = 0;
+			for (i = 0; i < num_packets; i++)
+			{
+				if (oi_packet_size(packet_ids[i]))
+					oi_decode(frame, packet_ids[i], &data[length]);
+				length += oi_packet_size(packet_ids[i]);
+			}
+			oi_frame_end();
+			// Polled frames come in on this thread, so a stop can go out at once
+			safety_service();
+			break;
+		}
+	}
+	oi_update_frame(self);
+}
+
+/// Pointer to the newest complete sensor frame
+const oi_frame_t *oi_frame_latest(void)
+{
+	return (const oi_frame_t *) &oi_frames[oi_frame_front];
+}
+
+/// Sequence number of the newest complete sensor frame
+uint16_t oi_frame_seq(void)
+{
+	uint8_t sreg = SREG;
+	uint16_t seq;
+
+	// Two byte reads; the receive interrupt must not publish a frame between them
+	cli();
+	seq = oi_frames[oi_frame_front].seq;
+	SREG = sreg;
+	return seq;
+}
+
+/// Copy the newest frame without holding off interrupts for the whole copy
+uint16_t oi_frame_copy(oi_frame_t *dest)
+{
+	volatile oi_frame_t *frame;
+	uint16_t seq;
+
+	// The receive interrupt only reuses a buffer two frames later, so a copy 
+	// is good if its sequence number did not change while copying
+	do {
+		frame = &oi_frames[oi_frame_front];
+		seq = frame->seq;
+		*dest = *frame;
+	} while (frame->seq != seq);
+
+	return seq;
+}
+
+/// Sleep until a frame newer than seq arrives
+const oi_frame_t *oi_frame_wait(uint16_t seq, unsigned int timeout_ms)
+{
+	unsigned long start = clock_ms();
+
+	// Every interrupt (a received byte, the 1 ms clock) wakes the CPU to check again
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	while ((int16_t) (oi_frame_seq() - seq) <= 0)
+	{
+		if (clock_ms() - start >= timeout_ms)
+			return 0;
+		sleep_mode();
+	}
+
+	return oi_frame_latest();
+}
+
+/// Starts the Create's sensor stream; see open_interface.h
+uint8_t oi_stream_start(oi_t *self, const uint8_t *packet_ids, uint8_t num_packets)
+{
+	uint8_t i;
+	uint16_t frame_bytes = 3 + num_packets; // header, length, checksum and IDs
+	oi_t *frame;
+
+	if (num_packets == 0 || num_packets > OI_STREAM_MAX_PACKETS)
+		return 0;
+	for (i = 0; i < num_packets; i++)
+	{
+		if (oi_packet_size(packet_ids[i]) == 0)
+			return 0;
+		frame_bytes += oi_packet_size(packet_ids[i]);
+	}
+	// Requesting more than fits in 15 ms corrupts the stream
+	if (frame_bytes > oi_link_state.stream_budget || frame_bytes - 3 > OI_STREAM_FRAME_MAX)
+		return 0;
+
+	if (oi_streaming)
+		oi_stream_stop();
+
+	// Fields that are not streamed keep their last polled values
+	frame = oi_frame_begin();
+	*frame = *self;
+	frame->distance = 0;
+	frame->angle = 0;
+	oi_frame_end();
+	oi_update_distance_sum = oi_frames[oi_frame_front].distance_sum;
+	oi_update_angle_sum = oi_frames[oi_frame_front].angle_sum;
+	oi_stream_expected = frame_bytes - 3;
+	oi_stream_state = OI_STREAM_WAIT_HEADER;
+
+	oi_byte_tx(OI_OPCODE_STREAM);
+	oi_byte_tx(num_packets);
+	for (i = 0; i < num_packets; i++)
+		oi_byte_tx(packet_ids[i]);
+
+	oi_stream_ids = packet_ids;
+	oi_stream_count = num_packets;
+	oi_streaming = 1;
+	UCSR1B |= (1 << RXCIE);
+	sei();
+	return 1;
+}
+
+/// Pauses the Create's sensor stream and returns to polled updates
+void oi_stream_stop(void)
+{
+	unsigned char discard;
+
+	if (!oi_streaming)
+		return;
+
+	// Stream state 0 pauses the stream
+	oi_byte_tx(OI_OPCODE_DO_STREAM);
+	oi_byte_tx(0);
+
+	UCSR1B &= ~(1 << RXCIE);
+	oi_streaming = 0;
+
+	// Let a frame that was already being sent finish, then drop it
+	wait_ms(20);
+	while (UCSR1A & (1 << RXC))
+		discard = UDR1;
+	(void) discard;
+}
+
+/// Returns 1 while the Create is streaming sensor data
+uint8_t oi_stream_active(void)
+{
+	return oi_streaming;
+}
+
+/// Sets the LEDs on the iRobot.
+/**
+* Set the state of the three LEDs on the iRobot (Power, Play, Advance).
+* @play_led        uint8_t either 0 (off) or 1 (on)
+* @advance_led     uint8_t either 0 (off) or 1 (on)
+* @power_color     uint8_t the color of the power LED; 0 = green, 255 = red
+* @power_intensity uint8_t the intensity of the power LED; 0 = off, 255 = full intensity
+*/
+void oi_set_leds(uint8_t play_led, uint8_t advance_led, uint8_t power_color, uint8_t power_intensity) 
+{
+	// LED Opcode
+	oi_byte_tx(OI_OPCODE_LEDS);
+
+	// Set the Play and Advance LEDs
+	oi_byte_tx(advance_led << 3 && play_led << 2);
+
+	// Set the power led color
+	oi_byte_tx(power_color);
+
+	// Set the power led intensity
+	oi_byte_tx(power_intensity);
+}
+
+/// Send a drive wheels command, no matter what was sent before
+static void oi_wheels_send(int16_t right_wheel, int16_t left_wheel)
+{
+	uint8_t command[5];
+
+	command[0] = OI_OPCODE_DRIVE_WHEELS;
+	command[1] = right_wheel >> 8;
+	command[2] = right_wheel & 0xff;
+	command[3] = left_wheel >> 8;
+	command[4] = left_wheel & 0xff;
+
+	// Only wait for room in the queue when it is nearly full
+	if (!oi_tx_write(command, sizeof(command)))
+	{
+		uint8_t i;
+		for (i = 0; i < sizeof(command); i++)
+			oi_byte_tx(command[i]);
+	}
+
+	oi_wheels_sent[0] = right_wheel;
+	oi_wheels_sent[1] = left_wheel;
+	oi_wheels_known = 1;
+	oi_wheels_held = 0;
+	oi_wheels_time = clock_ms();
+	oi_link_state.wheels_sent++;
+}
+
+/// Drive wheels directly; speeds are in mm / sec
+/**
+* Repeats are dropped and bursts are merged into one command per 
+* oi_wheels_interval; see open_interface.h.
+*/
+void oi_set_wheels(int16_t right_wheel, int16_t left_wheel) 
+{
+	uint8_t urgent;
+
+	if (oi_wheels_known && right_wheel == oi_wheels_sent[0] && left_wheel == oi_wheels_sent[1])
+	{
+		// A command still waiting would undo this one
+		if (oi_wheels_held)
+			oi_link_state.wheels_merged++;
+		oi_wheels_held = 0;
+		oi_link_state.wheels_duplicates++;
+		return;
+	}
+
+	// Stopping or reversing a wheel is never delayed
+	urgent = (right_wheel == 0 && left_wheel == 0) || !oi_wheels_known
+		|| (int32_t) right_wheel * oi_wheels_sent[0] < 0 
+		|| (int32_t) left_wheel * oi_wheels_sent[1] < 0;
+
+	if (urgent || clock_ms() - oi_wheels_time >= oi_wheels_interval)
+	{
+		if (oi_wheels_held)
+			oi_link_state.wheels_merged++;
+		oi_wheels_send(right_wheel, left_wheel);
+		return;
+	}
+
+	if (oi_wheels_held)
+		oi_link_state.wheels_merged++;
+	oi_wheels_waiting[0] = right_wheel;
+	oi_wheels_waiting[1] = left_wheel;
+	oi_wheels_held = 1;
+}
+
+/// Drive the wheel motors with a raw duty cycle
+void oi_set_wheels_pwm(int16_t right_pwm, int16_t left_pwm)
+{
+	uint8_t command[5];
+	uint8_t i;
+
+	right_pwm = MAX(-255, MIN(255, right_pwm));
+	left_pwm = MAX(-255, MIN(255, left_pwm));
+	command[0] = OI_OPCODE_DRIVE_PWM;
+	command[1] = right_pwm >> 8;
+	command[2] = right_pwm & 0xff;
+	command[3] = left_pwm >> 8;
+	command[4] = left_pwm & 0xff;
+
+	if (!oi_tx_write(command, sizeof(command)))
+	{
+		for (i = 0; i < sizeof(command); i++)
+			oi_byte_tx(command[i]);
+	}
+
+	// The next velocity command must be sent even if it matches the last one
+	oi_wheels_invalidate();
+}
+
+/// Drive along a circle
+void oi_set_drive(int16_t velocity, int16_t radius)
+{
+	uint8_t command[5];
+	uint8_t i;
+
+	velocity = MAX(-500, MIN(500, velocity));
+	if (radius != OI_RADIUS_STRAIGHT)
+		radius = MAX(-OI_RADIUS_MAX, MIN(OI_RADIUS_MAX, radius));
+	command[0] = OI_OPCODE_DRIVE;
+	command[1] = velocity >> 8;
+	command[2] = velocity & 0xff;
+	command[3] = radius >> 8;
+	command[4] = radius & 0xff;
+
+	if (!oi_tx_write(command, sizeof(command)))
+	{
+		for (i = 0; i < sizeof(command); i++)
+			oi_byte_tx(command[i]);
+	}
+
+	// The next velocity command must be sent even if it matches the last one
+	oi_wheels_invalidate();
+}
+
+/// Sets the shortest time between two wheel commands
+void oi_set_wheels_interval(unsigned int interval_ms)
+{
+	oi_wheels_interval = interval_ms;
+}
+
+/// Sends a wheel command held back by the rate limit
+void oi_wheels_flush(void)
+{
+	if (oi_wheels_held)
+		oi_wheels_send(oi_wheels_waiting[0], oi_wheels_waiting[1]);
+}
+
+/// Forgets the last wheel command and drops a waiting one
+void oi_wheels_invalidate(void)
+{
+	oi_wheels_known = 0;
+	oi_wheels_held = 0;
+}
+
+/// Loads a song onto the iRobot Create
+/// song index, number of notes, notes aray, duration array
+void oi_load_song(int song_index, int num_notes, unsigned char *notes, unsigned char *duration) 
+{
+	int i;
+	oi_byte_tx(OI_OPCODE_SONG);
+	oi_byte_tx(song_index);
+	oi_byte_tx(num_notes);
+	for (i=0;i<num_notes;i++) {
+		oi_byte_tx(notes[i]);
+		oi_byte_tx(duration[i]);
+	}
+}
+
+/// Plays a given song; use oi_load_song(...) first
+void oi_play_song(int index)
+{
+	oi_byte_tx(OI_OPCODE_PLAY);
+	oi_byte_tx(index);
+}
+
+/// Loads a script onto the Create; see open_interface.h
+uint8_t oi_script_load(const uint8_t *script, uint8_t length)
+{
+	uint8_t i;
+
+	if (length > OI_SCRIPT_MAX_LENGTH)
+		return 0;
+
+	oi_byte_tx(OI_OPCODE_SCRIPT);
+	oi_byte_tx(length);
+	for (i = 0; i < length; i++)
+		oi_byte_tx(script[i]);
+	return 1;
+}
+
+/// Runs the loaded script
+void oi_script_play(void)
+{
+	// The script drives the wheels on its own
+	oi_wheels_invalidate();
+	oi_byte_tx(OI_OPCODE_PLAY_SCRIPT);
+}
+
+/// Starts the home base search; see open_interface.h
+void oi_dock_start(unsigned long timeout_ms)
+{
+	// The stream lacks the charging packets, so poll them while docking
+	oi_dock_streamed = oi_streaming;
+	oi_stream_stop();
+
+	// The demo drives the wheels from here on
+	drive_set_now(0, 0);
+	oi_wheels_invalidate();
+
+	//Calling demo that will cause Create to seek out home base
+	oi_byte_tx(OI_OPCODE_MAX);
+	oi_byte_tx(0x01);
+
+	oi_dock_state.status = OI_DOCK_SEEKING;
+	oi_dock_state.elapsed_ms = 0;
+	oi_dock_started = clock_ms();
+	oi_dock_timeout = timeout_ms ? timeout_ms : OI_DOCK_TIMEOUT_DEFAULT;
+}
+
+/// Ends a docking run and brings the stream back
+static void oi_dock_finish(oi_t *self, uint8_t status)
+{
+	oi_dock_state.status = status;
+	if (oi_dock_streamed && self)
+		oi_stream_start(self, oi_stream_ids, oi_stream_count);
+	oi_dock_streamed = 0;
+}
+
+/// Checks on docking; see open_interface.h
+uint8_t oi_dock_poll(oi_t *self)
+{
+	if (oi_dock_state.status != OI_DOCK_SEEKING)
+	{
+		// oi_dock_cancel() has no sensor struct to resume the stream with
+		if (oi_dock_streamed)
+			oi_dock_finish(self, oi_dock_state.status);
+		return oi_dock_state.status;
+	}
+
+	oi_update_list(self, oi_dock_packets, sizeof(oi_dock_packets));
+	oi_dock_state.charging_state = self->charging_state;
+	oi_dock_state.home_base = self->home_base_charger_on;
+	oi_dock_state.infrared = self->infrared_byte;
+	oi_dock_state.elapsed_ms = clock_ms() - oi_dock_started;
+
+	if (self->home_base_charger_on)
+	{
+		oi_dock_finish(self, OI_DOCK_DOCKED);
+	}
+	else if (oi_dock_state.elapsed_ms >= oi_dock_timeout)
+	{
+		oi_dock_cancel();
+		oi_dock_finish(self, OI_DOCK_TIMEOUT);
+	}
+	return oi_dock_state.status;
+}
+
+/// Stops the home base search
+void oi_dock_cancel(void)
+{
+	if (oi_dock_state.status != OI_DOCK_SEEKING)
+		return;
+
+	// START ends the demo in Passive mode; Full mode gives control back
+	oi_byte_tx(OI_OPCODE_START);
+	oi_byte_tx(OI_OPCODE_FULL);
+	oi_wheels_invalidate();
+	drive_set_now(0, 0);
+	oi_dock_state.status = OI_DOCK_CANCELLED;
+}
+
+/// Returns the progress of the last docking run
+const oi_dock_t *oi_dock(void)
+{
+	return &oi_dock_state;
+}
+
+/// Runs default go charge program; robot will search for dock
+void go_charge(void) 
+{
+	oi_t sensor;
+
+	oi_dock_start(0);
+	while (oi_dock_poll(&sensor) == OI_DOCK_SEEKING)
+		;
+}
+
+/// Send the next queued byte; the caller must know UDR1 is empty
+static void oi_tx_next(void)
+{
+	// Clear TXC so oi_tx_flush() can tell when this byte has been shifted out;
+	// assigned, as a read-modify-write would write the error flags back
+	UCSR1A = (1 << U2X) | (1 << TXC);
+	UDR1 = oi_tx_buffer[oi_tx_tail];
+	oi_tx_tail = (oi_tx_tail + 1) & (OI_TX_BUFFER_SIZE - 1);
+	oi_tx_pending = 1;
+}
+
+/// USART1 data register empty interrupt; sends the transmit queue one byte at a time
+ISR (USART1_UDRE_vect)
+{
+	if (oi_tx_head == oi_tx_tail)
+	{
+		// Queue is empty, stop interrupting until oi_byte_tx() adds more
+		UCSR1B &= ~(1 << UDRIE);
+		return;
+	}
+	oi_tx_next();
+}
+
+// Queue a byte of data for transmission over the serial connection to the Create
+void oi_byte_tx(unsigned char value) 
+{
+	uint8_t next = (oi_tx_head + 1) & (OI_TX_BUFFER_SIZE - 1);
+
+	// Without interrupts nothing drains the queue, so send it directly
+	if (!(SREG & (1 << SREG_I)))
+	{
+		oi_tx_flush();
+		while (!(UCSR1A & (1 << UDRE)));
+		UCSR1A = (1 << U2X) | (1 << TXC);
+		UDR1 = value;
+		oi_tx_pending = 1;
+		return;
+	}
+
+	// Wait for the interrupt to make room when the queue is full
+	while (next == oi_tx_tail);
+
+	oi_tx_buffer[oi_tx_head] = value;
+	oi_tx_head = next;
+	UCSR1B |= (1 << UDRIE);
+}
+
+// Queue a whole command if it fits, without blocking
+uint8_t oi_tx_write(const uint8_t *data, uint8_t length)
+{
+	uint8_t i;
+
+	if (length > oi_tx_free() || !(SREG & (1 << SREG_I)))
+		return 0;
+
+	for (i = 0; i < length; i++)
+	{
+		oi_tx_buffer[oi_tx_head] = data[i];
+		oi_tx_head = (oi_tx_head + 1) & (OI_TX_BUFFER_SIZE - 1);
+	}
+	UCSR1B |= (1 << UDRIE);
+	return 1;
+}
+
+// Number of bytes that can be queued without blocking
+uint8_t oi_tx_free(void)
+{
+	// One slot stays empty to tell a full queue from an empty one
+	return (oi_tx_tail - oi_tx_head - 1) & (OI_TX_BUFFER_SIZE - 1);
+}
+
+// Block until the transmit queue is empty and the last byte has been sent
+void oi_tx_flush(void)
+{
+	while (oi_tx_head != oi_tx_tail)
+	{
+		// With interrupts off the queue has to be drained here
+		if (!(SREG & (1 << SREG_I)) && (UCSR1A & (1 << UDRE)))
+			oi_tx_next();
+	}
+
+	if (oi_tx_pending)
+	{
+		while (!(UCSR1A & (1 << TXC)));
+		oi_tx_pending = 0;
+	}
+}
+
+// Receive a byte of data from the Create serial connection. Blocks until a byte is received.
+unsigned char oi_byte_rx(void) 
+{
+	// wait until a byte is received (Receive Complete flag, RXC, is set)
+	while (!(UCSR1A & (1 << RXC)));
+
+	return UDR1;
+}
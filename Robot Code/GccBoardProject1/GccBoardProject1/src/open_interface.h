@@ -1,204 +1,462 @@
-/** 
- * Open Interface API - Provides a set of functions for controlling the Create 
- * Documentation: http://www.irobot.com/filelibrary/pdfs/hrd/create/create%20open%20interface_v2.pdf
- *
- * void main() {
- *    oi_sensors_t *robot = oi_alloc();
- *    oi_init(robot);
- *
- *    // ... your code ...
- *
- *    free(robot);
- * }
- * 
- * @author See "Robotics Primer Workbook" project hosted on SourceForge.Net; Edited for clarity by Chad Nelson
- * @date 06/26/2012
- */
-
-#ifndef CREATE_H
-#define CREATE_H
-
-#define FOSC 16000000
-
-#include <inttypes.h>
-#include <avr/io.h>
-
-#define OI_OPCODE_START            128
-#define OI_OPCODE_BAUD             129
-#define OI_OPCODE_CONTROL          130
-#define OI_OPCODE_SAFE             131
-#define OI_OPCODE_FULL             132
-#define OI_OPCODE_POWER            133
-#define OI_OPCODE_SPOT             134
-#define OI_OPCODE_CLEAN            135
-#define OI_OPCODE_MAX              136
-#define OI_OPCODE_DRIVE            137
-#define OI_OPCODE_MOTORS           138
-#define OI_OPCODE_LEDS             139
-#define OI_OPCODE_SONG             140
-#define OI_OPCODE_PLAY             141
-#define OI_OPCODE_SENSORS          142
-#define OI_OPCODE_FORCEDOCK        143
-
-#define OI_OPCODE_PWM_MOTORS       144
-#define OI_OPCODE_DRIVE_WHEELS     145
-#define OI_OPCODE_DRIVE_PWM        146
-#define OI_OPCODE_OUTPUTS          147
-#define OI_OPCODE_STREAM           148
-#define OI_OPCODE_QUERY_LIST       149
-#define OI_OPCODE_DO_STREAM        150
-#define OI_OPCODE_SEND_IR_CHAR     151
-#define OI_OPCODE_SCRIPT           152
-#define OI_OPCODE_PLAY_SCRIPT      153
-#define OI_OPCODE_SHOW_SCRIPT      154
-#define OI_OPCODE_WAIT_TIME        155
-#define OI_OPCODE_WAIT_DISTANCE    156
-#define OI_OPCODE_WAIT_ANGLE       157
-#define OI_OPCODE_WAIT_EVENT       158
-
-// Contains Packets 7-26
-#define OI_SENSOR_PACKET_GROUP0 0
-// Contains Packets 7-16
-#define OI_SENSOR_PACKET_GROUP1 1
-// Contains Packets 17-20
-#define OI_SENSOR_PACKET_GROUP2 2
-// Contains Packets 21-26
-#define OI_SENSOR_PACKET_GROUP3 3
-// Contains Packets 27-34
-#define OI_SENSOR_PACKET_GROUP4 4
-// Contains Packets 35-42
-#define OI_SENSOR_PACKET_GROUP5 5
-// Contains Packets 7-42
-#define OI_SENSOR_PACKET_GROUP6 6
-
-#define MIN(a,b) ((a < b) ? (a) : (b))
-#define MAX(a,b) ((a > b) ? (a) : (b))
-
-#define PIN_0 0x01
-#define PIN_1 0x02
-#define PIN_2 0x04
-#define PIN_3 0x08
-#define PIN_4 0x10
-#define PIN_5 0x20
-#define PIN_6 0x40
-#define PIN_7 0x80
-
-/// iRobot Create Sensor Data
-typedef struct {
-	// Sensor statuses (booleans)
-	uint8_t bumper_right : 1;
-	uint8_t bumper_left : 1;
-	uint8_t wheeldrop_right : 1;
-	uint8_t wheeldrop_left : 1;
-	uint8_t wheeldrop_caster : 1;
-	uint8_t wall; // not virtual wall
-	uint8_t cliff_left;
-	uint8_t cliff_frontleft;
-	uint8_t cliff_frontright;
-	uint8_t cliff_right;
-	uint8_t virtual_wall; // omni-directional IR sensor
-	
-	// Over current information
-	uint8_t overcurrent_ld1 : 1;
-	uint8_t overcurrent_ld0 : 1;
-	uint8_t overcurrent_ld2 : 1;
-	uint8_t overcurrent_driveright : 1;
-	uint8_t overcurrent_driveleft : 1;
-
-	uint16_t unused_bytes;
-	
-	uint8_t infrared_byte;
-	uint8_t button_play : 2;
-	uint8_t button_advance : 1;
-
-	int16_t distance; // in millimeters
-	int16_t angle;    // in degrees; counterclockwise is positive; clockwise is negative
-
-	// Battery information
-	uint8_t charging_state;
-	uint16_t voltage; // mV
-	int16_t current; // mA
-	int8_t temperature; // Celcius
-	uint16_t charge;
-	uint16_t capacity; // mA-hrs
-	
-	// Light sensor signal strengths
-	uint16_t wall_signal; 
-	uint16_t cliff_left_signal;
-	uint16_t cliff_frontleft_signal;
-	uint16_t cliff_frontright_signal;
-	uint16_t cliff_right_signal;
-	
-	// Cargo bay info
-	uint8_t cargo_bay_io0 : 1;
-	uint8_t cargo_bay_io1 : 1;
-	uint8_t cargo_bay_io2 : 1;
-	uint8_t cargo_bay_io3 : 1;
-	uint8_t cargo_bay_baud : 1;
-	uint16_t cargo_bay_voltage;
-	
-	uint8_t internal_charger_on : 1;
-	uint8_t home_base_charger_on : 1;
-	
-	uint8_t oi_mode; // off, passive, safe, full
-	
-	uint8_t song_number;
-	uint8_t song_playing;
-	
-	uint8_t number_packets;
-	int16_t requested_velocity;
-	int16_t requested_radius;
-	int16_t requested_right_velocity;
-	int16_t requested_left_velocity;
-} oi_t;
-
-typedef oi_t oi_sensors_t;
-
-/// Allocate memory for the oi_sensor_t struct 
-oi_t * oi_alloc(void);
-
-/// Initialize the Create. This must be called first.
-void oi_init(oi_t *self);
-
-void oi_free(oi_t *self);
-
-/// Update the Create. This will update all the sensor data.
-void oi_update(oi_t *self);
-
-/// \brief Set the LEDS on the Create
-/// \param play_led 0=off, 1=on
-/// \param advance_led 0=off, 1=on
-/// \param power_color (0-255), 0=green, 255=red
-/// \param power_intensity (0-255) 0=off, 255=full intensity
-void oi_set_leds(uint8_t play_led, uint8_t advance_led, uint8_t power_color, uint8_t power_intensity);
-
-/// \brief Set direction and speed of the robot's wheels
-/// \param linear velocity in mm/s values range from -500 -> 500 of right wheel
-/// \param linear velocity in mm/s values range from -500 -> 500 of left wheel
-void oi_set_wheels(int16_t right_wheel, int16_t left_wheel);
-
-/// \brief Transmit a byte of data over the serial connection to the Create 
-/// \param value 8-bit value to transmit to the Create
-void oi_byte_tx(unsigned char value);
-
-/// \brief Receive a byte of data from the Create serial connection. Blocks 
-/// until a byte is received.
-/// \return 8-bit value returned from the Create
-unsigned char oi_byte_rx(void);
-
-/// \brief Load song sequence
-/// \param An integer value from 0 - 15 that acts as a label for note sequence
-/// \param An integer value from 1 - 16 indicating the number of notes in the sequence
-/// \param A pointer to a sequence of notes stored as integer values
-/// \param A pointer to a sequence of durations that correspond to the notes
-void oi_load_song(int song_index, int num_notes, unsigned char  *notes, unsigned char  *duration);
-
-/// \brief Play song
-/// \param An integer value from 0 - 15 that is a previously establish song index
-void oi_play_song(int index);
-
-/// Calls in built in demo to send the iRobot to an open home base
-/// This will cause the iRobot to enter the Passive state
-void go_charge(void);
-
+/** 
+ * Open Interface API - Provides a set of functions for controlling the Create 
+ * Documentation: http://www.irobot.com/filelibrary/pdfs/hrd/create/create%20open%20interface_v2.pdf
+ *
+ * void main() {
+ *    oi_sensors_t *robot = oi_alloc();
+ *    oi_init(robot);
+ *
+ *    // ... your code ...
+ *
+ *    free(robot);
+ * }
+ * 
+ * @author See "Robotics Primer Workbook" project hosted on SourceForge.Net; Edited for clarity by Chad Nelson
+ * @date 06/26/2012
+ */
+
+#ifndef CREATE_H
+#define CREATE_H
+
+#define FOSC 16000000
+
+#include <inttypes.h>
+#include <avr/io.h>
+
+#define OI_OPCODE_START            128
+#define OI_OPCODE_BAUD             129
+#define OI_OPCODE_CONTROL          130
+#define OI_OPCODE_SAFE             131
+#define OI_OPCODE_FULL             132
+#define OI_OPCODE_POWER            133
+#define OI_OPCODE_SPOT             134
+#define OI_OPCODE_CLEAN            135
+#define OI_OPCODE_MAX              136
+#define OI_OPCODE_DRIVE            137
+#define OI_OPCODE_MOTORS           138
+#define OI_OPCODE_LEDS             139
+#define OI_OPCODE_SONG             140
+#define OI_OPCODE_PLAY             141
+#define OI_OPCODE_SENSORS          142
+#define OI_OPCODE_FORCEDOCK        143
+
+#define OI_OPCODE_PWM_MOTORS       144
+#define OI_OPCODE_DRIVE_WHEELS     145
+#define OI_OPCODE_DRIVE_PWM        146
+#define OI_OPCODE_OUTPUTS          147
+#define OI_OPCODE_STREAM           148
+#define OI_OPCODE_QUERY_LIST       149
+#define OI_OPCODE_DO_STREAM        150
+#define OI_OPCODE_SEND_IR_CHAR     151
+#define OI_OPCODE_SCRIPT           152
+#define OI_OPCODE_PLAY_SCRIPT      153
+#define OI_OPCODE_SHOW_SCRIPT      154
+#define OI_OPCODE_WAIT_TIME        155
+#define OI_OPCODE_WAIT_DISTANCE    156
+#define OI_OPCODE_WAIT_ANGLE       157
+#define OI_OPCODE_WAIT_EVENT       158
+
+// Contains Packets 7-26
+#define OI_SENSOR_PACKET_GROUP0 0
+// Contains Packets 7-16
+#define OI_SENSOR_PACKET_GROUP1 1
+// Contains Packets 17-20
+#define OI_SENSOR_PACKET_GROUP2 2
+// Contains Packets 21-26
+#define OI_SENSOR_PACKET_GROUP3 3
+// Contains Packets 27-34
+#define OI_SENSOR_PACKET_GROUP4 4
+// Contains Packets 35-42
+#define OI_SENSOR_PACKET_GROUP5 5
+// Contains Packets 7-42
+#define OI_SENSOR_PACKET_GROUP6 6
+
+// Individual sensor packets (see the Open Interface documentation for sizes)
+#define OI_SENSOR_BUMPS_WHEELDROPS        7
+#define OI_SENSOR_WALL                    8
+#define OI_SENSOR_CLIFF_LEFT              9
+#define OI_SENSOR_CLIFF_FRONT_LEFT       10
+#define OI_SENSOR_CLIFF_FRONT_RIGHT      11
+#define OI_SENSOR_CLIFF_RIGHT            12
+#define OI_SENSOR_VIRTUAL_WALL           13
+#define OI_SENSOR_OVERCURRENTS           14
+#define OI_SENSOR_INFRARED_BYTE          17
+#define OI_SENSOR_BUTTONS                18
+#define OI_SENSOR_DISTANCE               19
+#define OI_SENSOR_ANGLE                  20
+#define OI_SENSOR_CHARGING_STATE         21
+#define OI_SENSOR_VOLTAGE                22
+#define OI_SENSOR_CURRENT                23
+#define OI_SENSOR_TEMPERATURE            24
+#define OI_SENSOR_CHARGE                 25
+#define OI_SENSOR_CAPACITY               26
+#define OI_SENSOR_WALL_SIGNAL            27
+#define OI_SENSOR_CLIFF_LEFT_SIGNAL      28
+#define OI_SENSOR_CLIFF_FRONT_LEFT_SIGNAL  29
+#define OI_SENSOR_CLIFF_FRONT_RIGHT_SIGNAL 30
+#define OI_SENSOR_CLIFF_RIGHT_SIGNAL     31
+#define OI_SENSOR_CARGO_BAY_DIGITAL      32
+#define OI_SENSOR_CARGO_BAY_ANALOG       33
+#define OI_SENSOR_CHARGING_SOURCES       34
+#define OI_SENSOR_OI_MODE                35
+#define OI_SENSOR_SONG_NUMBER            36
+#define OI_SENSOR_SONG_PLAYING           37
+#define OI_SENSOR_NUMBER_STREAM_PACKETS  38
+#define OI_SENSOR_REQUESTED_VELOCITY     39
+#define OI_SENSOR_REQUESTED_RADIUS       40
+#define OI_SENSOR_REQUESTED_RIGHT_VELOCITY 41
+#define OI_SENSOR_REQUESTED_LEFT_VELOCITY  42
+
+// Highest sensor packet ID understood by the decoder
+#define OI_SENSOR_PACKET_MAX 42
+
+// Every stream frame starts with this byte, followed by the length and data
+#define OI_STREAM_HEADER 19
+// Maximum number of packet IDs that can be streamed at once
+#define OI_STREAM_MAX_PACKETS 16
+// Longest script the Create can store
+#define OI_SCRIPT_MAX_LENGTH 100
+
+// Size of the USART1 transmit queue; must be a power of two
+#define OI_TX_BUFFER_SIZE 64
+
+// Default shortest time between two wheel commands (ms); the Create reads 
+// its commands every 15 ms
+#define OI_WHEELS_INTERVAL_DEFAULT 15
+
+// Docking status, from oi_dock_poll()
+#define OI_DOCK_IDLE      0
+#define OI_DOCK_SEEKING   1
+#define OI_DOCK_DOCKED    2
+#define OI_DOCK_TIMEOUT   3
+#define OI_DOCK_CANCELLED 4
+// Give up on finding the home base after this long (ms)
+#define OI_DOCK_TIMEOUT_DEFAULT 120000UL
+
+// Create baud codes for the link rates the USART can hit at 16 MHz
+#define OI_BAUD_28800  8
+#define OI_BAUD_38400  9
+#define OI_BAUD_57600  10  // the Create's rate after power up
+#define OI_BAUD_115200 11
+// Link rate oi_init() asks for; it falls back when the link does not validate.
+// 57600 is 0.8% off at 16 MHz. 115200 is 2.1% off, past the receiver's
+// tolerance for 8N1, and fails under a steady stream even when the short
+// check passes, so it is only used when the build defines it here.
+#ifndef OI_BAUD_DEFAULT
+#define OI_BAUD_DEFAULT OI_BAUD_57600
+#endif
+
+#define MIN(a,b) ((a < b) ? (a) : (b))
+#define MAX(a,b) ((a > b) ? (a) : (b))
+
+#define PIN_0 0x01
+#define PIN_1 0x02
+#define PIN_2 0x04
+#define PIN_3 0x08
+#define PIN_4 0x10
+#define PIN_5 0x20
+#define PIN_6 0x40
+#define PIN_7 0x80
+
+/// iRobot Create Sensor Data
+typedef struct {
+	// Sensor statuses (booleans)
+	uint8_t bumper_right : 1;
+	uint8_t bumper_left : 1;
+	uint8_t wheeldrop_right : 1;
+	uint8_t wheeldrop_left : 1;
+	uint8_t wheeldrop_caster : 1;
+	uint8_t wall; // not virtual wall
+	uint8_t cliff_left;
+	uint8_t cliff_frontleft;
+	uint8_t cliff_frontright;
+	uint8_t cliff_right;
+	uint8_t virtual_wall; // omni-directional IR sensor
+	
+	// Over current information
+	uint8_t overcurrent_ld1 : 1;
+	uint8_t overcurrent_ld0 : 1;
+	uint8_t overcurrent_ld2 : 1;
+	uint8_t overcurrent_driveright : 1;
+	uint8_t overcurrent_driveleft : 1;
+
+	uint16_t unused_bytes;
+	
+	uint8_t infrared_byte;
+	uint8_t button_play : 2;
+	uint8_t button_advance : 1;
+
+	int16_t distance; // in millimeters
+	int16_t angle;    // in degrees; counterclockwise is positive; clockwise is negative
+
+	// Battery information
+	uint8_t charging_state;
+	uint16_t voltage; // mV
+	int16_t current; // mA
+	int8_t temperature; // Celcius
+	uint16_t charge;
+	uint16_t capacity; // mA-hrs
+	
+	// Light sensor signal strengths
+	uint16_t wall_signal; 
+	uint16_t cliff_left_signal;
+	uint16_t cliff_frontleft_signal;
+	uint16_t cliff_frontright_signal;
+	uint16_t cliff_right_signal;
+	
+	// Cargo bay info
+	uint8_t cargo_bay_io0 : 1;
+	uint8_t cargo_bay_io1 : 1;
+	uint8_t cargo_bay_io2 : 1;
+	uint8_t cargo_bay_io3 : 1;
+	uint8_t cargo_bay_baud : 1;
+	uint16_t cargo_bay_voltage;
+	
+	uint8_t internal_charger_on : 1;
+	uint8_t home_base_charger_on : 1;
+	
+	uint8_t oi_mode; // off, passive, safe, full
+	
+	uint8_t song_number;
+	uint8_t song_playing;
+	
+	uint8_t number_packets;
+	int16_t requested_velocity;
+	int16_t requested_radius;
+	int16_t requested_right_velocity;
+	int16_t requested_left_velocity;
+} oi_t;
+
+typedef oi_t oi_sensors_t;
+
+/// State and error counts of the serial link to the Create
+typedef struct {
+	unsigned long baud;       // achieved rate in bits/s (FOSC / UBRR divider)
+	uint8_t baud_code;        // Create baud code currently in use
+	uint8_t stream_budget;    // bytes that fit in one 15 ms stream frame
+	uint8_t baud_fallbacks;   // rate changes that failed validation
+	uint8_t check_errors;     // validation reads that timed out or were wrong
+	unsigned int frames_good;    // sensor frames received and decoded
+	unsigned int frames_dropped; // frames lost to a receive error or a timeout
+	unsigned int frames_corrupt; // stream frames whose checksum did not match
+	unsigned int framing_errors; // bytes received with FE set
+	unsigned int overruns;       // bytes received with DOR set
+	unsigned int parity_errors;  // bytes received with UPE set
+	unsigned int wheels_sent;       // wheel commands sent to the Create
+	unsigned int wheels_duplicates; // wheel commands dropped as repeats
+	unsigned int wheels_merged;     // wheel commands replaced by a newer one
+} oi_link_t;
+
+/// Progress of a docking run
+typedef struct {
+	uint8_t status;         // OI_DOCK_IDLE .. OI_DOCK_CANCELLED
+	uint8_t charging_state; // packet 21: 0 not charging, 1-3 charging, 4 waiting, 5 fault
+	uint8_t home_base;      // 1 while the home base charger is connected
+	uint8_t infrared;       // packet 17: which of the base's beams the robot sees
+	unsigned long elapsed_ms; // since oi_dock_start()
+} oi_dock_t;
+
+/// One complete set of sensor data, as published by oi_update() or the stream
+typedef struct {
+	oi_t data;              // distance and angle hold the change in this frame only
+	int16_t distance_sum;   // running total of distance (mm), wraps around
+	int16_t angle_sum;      // running total of angle (degrees), wraps around
+	unsigned long time_ms;  // clock_ms() when the frame was completed
+	uint16_t seq;           // incremented for every frame
+} oi_frame_t;
+
+/// Allocate memory for the oi_sensor_t struct 
+oi_t * oi_alloc(void);
+
+/// Initialize the Create. This must be called first, after clock_init().
+void oi_init(oi_t *self);
+
+void oi_free(oi_t *self);
+
+/// Update the Create. This will update all the sensor data.
+/// A reply that times out or arrives with a receive error is asked for once
+/// more; if that fails too, self keeps its previous values (see oi_link()).
+void oi_update(oi_t *self);
+
+/// \brief Change the link rate. The Create is told to switch, the USART 
+/// follows, and the new rate is checked by reading back known sensor packets. 
+/// If that fails, the link drops back to the previous rate. The sensor stream 
+/// must be stopped first.
+/// \param baud_code OI_BAUD_28800, OI_BAUD_38400, OI_BAUD_57600 or OI_BAUD_115200
+/// \return 1 if the new rate is in use, 0 if the previous rate was kept
+uint8_t oi_set_baud(uint8_t baud_code);
+
+/// \return achieved link rate and error counts
+const oi_link_t *oi_link(void);
+
+/// \brief Update only the listed sensor packets (query list, opcode 149).
+/// Much cheaper than oi_update() when only a few values are needed; other
+/// fields keep their previous values, except distance and angle, which are 0
+/// when not requested. While streaming this is the same as oi_update().
+/// \param self struct to update
+/// \param packet_ids list of packet IDs (7-42) or group IDs (0-6) to read
+/// \param num_packets number of IDs in the list; the replies may add up to at
+/// most 64 bytes, otherwise self is left unchanged
+void oi_update_list(oi_t *self, const uint8_t *packet_ids, uint8_t num_packets);
+
+/// \brief Newest complete sensor frame. Received data goes into a second 
+/// buffer, so the frame stays untouched until the next one completes (at least
+/// 15 ms when streaming). Readers that keep the pointer longer should check
+/// that seq did not change, or use oi_frame_copy().
+const oi_frame_t *oi_frame_latest(void);
+
+/// \return sequence number of the newest complete sensor frame
+uint16_t oi_frame_seq(void);
+
+/// \brief Copy the newest frame consistently, without disabling interrupts
+/// \param dest where to copy the frame
+/// \return sequence number of the copied frame
+uint16_t oi_frame_copy(oi_frame_t *dest);
+
+/// \brief Sleep (idle mode) until a frame newer than seq is complete
+/// \param seq sequence number the caller already has
+/// \param timeout_ms give up after this many milliseconds
+/// \return the new frame, or 0 on timeout
+const oi_frame_t *oi_frame_wait(uint16_t seq, unsigned int timeout_ms);
+
+/// \brief Start streaming sensor packets from the Create.
+/// The Create sends the requested packets every 15 ms. They are parsed by the
+/// USART1 receive interrupt, and oi_update() then returns the newest data
+/// immediately instead of querying the Create. distance and angle returned by 
+/// oi_update() are summed over all frames received since the previous call.
+/// \param self struct whose current values seed fields that are not streamed
+/// \param packet_ids list of packet IDs (7-42) or group IDs (0-6) to stream
+/// \param num_packets number of IDs in the list, at most OI_STREAM_MAX_PACKETS
+/// \return 1 if streaming started, 0 if the request does not fit in a 15 ms
+/// frame at the current link rate (43 bytes at 28800 baud, 85 at 57600)
+/// \note Frames with a bad checksum or a receive error are dropped and counted
+/// in oi_link(); the parser then looks for the next header.
+uint8_t oi_stream_start(oi_t *self, const uint8_t *packet_ids, uint8_t num_packets);
+
+/// Stop the sensor stream; oi_update() goes back to querying the Create
+void oi_stream_stop(void);
+
+/// \return 1 while a sensor stream is active
+uint8_t oi_stream_active(void);
+
+/// \return number of sensor data bytes sent for a packet or group ID, 0 if unknown
+uint8_t oi_packet_size(uint8_t packet_id);
+
+/// \brief Set the LEDS on the Create
+/// \param play_led 0=off, 1=on
+/// \param advance_led 0=off, 1=on
+/// \param power_color (0-255), 0=green, 255=red
+/// \param power_intensity (0-255) 0=off, 255=full intensity
+void oi_set_leds(uint8_t play_led, uint8_t advance_led, uint8_t power_color, uint8_t power_intensity);
+
+/// \brief Set direction and speed of the robot's wheels
+/// A command equal to the last one is dropped. Commands are sent at most once
+/// per oi_set_wheels_interval(); one that comes sooner waits, replacing any
+/// command already waiting, and is sent by oi_update() or oi_wheels_flush(). 
+/// Stops and reversals of either wheel are always sent at once.
+/// \param linear velocity in mm/s values range from -500 -> 500 of right wheel
+/// \param linear velocity in mm/s values range from -500 -> 500 of left wheel
+void oi_set_wheels(int16_t right_wheel, int16_t left_wheel);
+
+/// \brief Drive the wheel motors with a raw PWM duty cycle (opcode 146),
+/// skipping the Create's own velocity control. Sent at once; not coalesced.
+/// \param right_pwm duty cycle of the right wheel, -255 to 255
+/// \param left_pwm duty cycle of the left wheel, -255 to 255
+void oi_set_wheels_pwm(int16_t right_pwm, int16_t left_pwm);
+
+/// Special radii of oi_set_drive()
+#define OI_RADIUS_STRAIGHT	((int16_t) 0x8000)
+#define OI_RADIUS_SPIN_CW	-1
+#define OI_RADIUS_SPIN_CCW	1
+/// Largest radius the Create accepts, in mm
+#define OI_RADIUS_MAX		2000
+
+/// \brief Drive along a circle (opcode 137). Sent at once; not coalesced.
+/// \param velocity mm/s of the center of the robot, -500 to 500
+/// \param radius mm to the center of the circle, -2000 to 2000, positive to
+/// the left; or one of the OI_RADIUS_ values
+void oi_set_drive(int16_t velocity, int16_t radius);
+
+/// \brief Set the shortest time between two wheel commands
+/// \param interval_ms 0 sends every command that is not a repeat
+void oi_set_wheels_interval(unsigned int interval_ms);
+
+/// Send a wheel command held back by the rate limit now. Call before 
+/// blocking for a while without oi_update().
+void oi_wheels_flush(void);
+
+/// Forget the last wheel command so the next one is sent even if it is the
+/// same. Needed when something other than oi_set_wheels() changed the wheels,
+/// like a script or a mode change; also drops a command that is waiting.
+void oi_wheels_invalidate(void);
+
+/// \brief Queue a byte of data for transmission to the Create. The byte is 
+/// sent in the background by the USART1 data register empty interrupt; this 
+/// only blocks while the transmit queue is full.
+/// \param value 8-bit value to transmit to the Create
+void oi_byte_tx(unsigned char value);
+
+/// \brief Queue a whole command without blocking
+/// \param data bytes to transmit to the Create
+/// \param length number of bytes
+/// \return 1 if queued, 0 if the queue did not have room (nothing is queued)
+uint8_t oi_tx_write(const uint8_t *data, uint8_t length);
+
+/// \return number of bytes that can be queued without blocking
+uint8_t oi_tx_free(void);
+
+/// Block until every queued byte has left the USART, e.g. before a baud change
+void oi_tx_flush(void);
+
+/// \brief Receive a byte of data from the Create serial connection. Blocks 
+/// until a byte is received.
+/// \return 8-bit value returned from the Create
+unsigned char oi_byte_rx(void);
+
+/// \brief Load song sequence
+/// \param An integer value from 0 - 15 that acts as a label for note sequence
+/// \param An integer value from 1 - 16 indicating the number of notes in the sequence
+/// \param A pointer to a sequence of notes stored as integer values
+/// \param A pointer to a sequence of durations that correspond to the notes
+void oi_load_song(int song_index, int num_notes, unsigned char  *notes, unsigned char  *duration);
+
+/// \brief Play song
+/// \param An integer value from 0 - 15 that is a previously establish song index
+void oi_play_song(int index);
+
+/// \brief Load a script onto the Create, replacing the previous one.
+/// The script is a list of ordinary commands that the Create runs on its own
+/// once oi_script_play() is sent.
+/// \param script command bytes
+/// \param length number of bytes, at most OI_SCRIPT_MAX_LENGTH
+/// \return 1 if loaded, 0 if the script is too long
+uint8_t oi_script_load(const uint8_t *script, uint8_t length);
+
+/// Run the script loaded with oi_script_load()
+void oi_script_play(void);
+
+/// \brief Start the built in demo that sends the iRobot to an open home base.
+/// The Create drives on its own in Passive mode; follow it with oi_dock_poll().
+/// The sensor stream is paused while docking and resumed afterwards.
+/// \param timeout_ms give up after this long; 0 for OI_DOCK_TIMEOUT_DEFAULT
+void oi_dock_start(unsigned long timeout_ms);
+
+/// \brief Check on docking; call it often while the status is OI_DOCK_SEEKING.
+/// Once docked the Create stays in Passive mode so it charges. On a timeout
+/// the search is cancelled.
+/// \param self sensor struct, updated with the docking packets
+/// \return OI_DOCK_IDLE, _SEEKING, _DOCKED, _TIMEOUT or _CANCELLED
+uint8_t oi_dock_poll(oi_t *self);
+
+/// Stop searching for the home base and take back control in Full mode
+void oi_dock_cancel(void);
+
+/// \return progress of the last docking run
+const oi_dock_t *oi_dock(void);
+
+/// Calls in built in demo to send the iRobot to an open home base
+/// This will cause the iRobot to enter the Passive state. Blocks until docked
+/// or OI_DOCK_TIMEOUT_DEFAULT passed; oi_dock_start() does not block.
+void go_charge(void);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,425 @@
+/**
+*	@file	planner.c
+*	@brief	Incremental wavefront planner over the occupancy grid.
+*	@date	10/17/2026
+*/
+
+#include <string.h>
+#include "util.h"
+#include "open_interface.h"
+#include "odometry.h"
+#include "pursuit.h"
+#include "grid.h"
+#include "planner.h"
+
+/// Planner cells per side of the finest plan
+#define PLAN_SIZE_MAX (GRID_SIZE / PLAN_BLOCK_MIN)
+/// Work of one plan_service(): a cell looked at costs 1, a neighbour checked
+/// for room the grid cells it reads, a straight line PLAN_LINE_COST
+#define PLAN_BUDGET		1024
+#define PLAN_LINE_COST	1024
+
+/// What plan_service() works on
+#define PLAN_PHASE_SEARCH	0	// spread the wave from the goal
+#define PLAN_PHASE_TRACE	1	// run down it from the robot
+
+/// The wave, 2 bits a cell: 0 if not reached, else 1 + steps from the goal
+/// mod 3. That is enough to run down it, as neighbours are one step apart at most.
+static uint8_t plan_wave[PLAN_SIZE_MAX * PLAN_SIZE_MAX / 4];
+/// Neighbours of a cell: right, up, left, down
+static const int8_t plan_dx[4] = {1, 0, -1, 0};
+static const int8_t plan_dy[4] = {0, 1, 0, -1};
+
+/// Grid cells per planner cell, for the next plan and for this one
+static uint8_t plan_block_next = PLAN_BLOCK_DEFAULT;
+static uint8_t plan_block = PLAN_BLOCK_DEFAULT;
+static plan_result_t plan_last;
+static uint8_t plan_phase = PLAN_PHASE_SEARCH;
+/// Goal and robot in mm, and their planner cells
+static int16_t plan_goal_x, plan_goal_y, plan_robot_x, plan_robot_y;
+static uint8_t plan_goal_column, plan_goal_row, plan_robot_column, plan_robot_row;
+/// grid_changes() the plan is made from
+static uint8_t plan_grid;
+/// Next cell to look at: of the scan in the search, of the way in the trace
+static uint8_t plan_column, plan_row;
+/// Set once the front being scanned reached a new cell
+static uint8_t plan_grew;
+/// Last waypoint, and the furthest point of the way seen straight from it
+static int16_t plan_anchor_x, plan_anchor_y, plan_last_x, plan_last_y;
+static unsigned long plan_began;
+
+/**
+*	This method reads a cell of the wave
+*	@param	column	x index
+*	@param	row		y index
+*	@return	0 if not reached, else 1 + steps from the goal mod 3
+*	@date	10/17/2026
+*/
+static uint8_t plan_get(uint8_t column, uint8_t row)
+{
+	return (plan_wave[(row * PLAN_SIZE_MAX + column) / 4] >> ((column & 3) * 2)) & 3;
+}
+
+/**
+*	This method marks a cell of the wave as reached
+*	@param	column	x index
+*	@param	row		y index
+*	@param	label	1 + steps from the goal mod 3
+*	@date	10/17/2026
+*/
+static void plan_set(uint8_t column, uint8_t row, uint8_t label)
+{
+	uint8_t *cell = &plan_wave[(row * PLAN_SIZE_MAX + column) / 4];
+
+	*cell |= label << ((column & 3) * 2);
+}
+
+/**
+*	This method checks whether the robot fits in a planner cell: none of its
+*	grid cells, nor the ones around them, were seen occupied. Unknown counts
+*	as free; a sweep that finds otherwise starts the plan over.
+*	@param	column	x index
+*	@param	row		y index
+*	@return	1 if there is room
+*	@date	10/17/2026
+*/
+static uint8_t plan_room(uint8_t column, uint8_t row)
+{
+	int16_t first_i = column * plan_block - 1;
+	int16_t first_j = row * plan_block - 1;
+	int16_t i, j;
+
+	/// Off the grid is -1 or past the end, which grid_get() reads as unknown
+	for (j = first_j; j <= first_j + plan_block + 1; j++)
+		for (i = first_i; i <= first_i + plan_block + 1; i++)
+			if (grid_get((uint8_t) i, (uint8_t) j) >= GRID_SEEN)
+				return 0;
+	return 1;
+}
+
+/**
+*	This method finds the planner cell a point is in
+*	@param	x_mm	x of the point
+*	@param	y_mm	y of the point
+*	@param	column	Where to store the column
+*	@param	row		Where to store the row
+*	@return	0 if the point is off the plan
+*	@date	10/17/2026
+*/
+static uint8_t plan_locate(int16_t x_mm, int16_t y_mm, uint8_t *column, uint8_t *row)
+{
+	if (!grid_cell(x_mm, y_mm, column, row))
+		return 0;
+	*column /= plan_block;
+	*row /= plan_block;
+	return *column < GRID_SIZE / plan_block && *row < GRID_SIZE / plan_block;
+}
+
+/**
+*	This method finds the middle of a planner cell
+*	@param	column	x index
+*	@param	row		y index
+*	@param	x_mm	Where to store x
+*	@param	y_mm	Where to store y
+*	@date	10/17/2026
+*/
+static void plan_center(uint8_t column, uint8_t row, int16_t *x_mm, int16_t *y_mm)
+{
+	int16_t origin_x, origin_y;
+
+	grid_origin(&origin_x, &origin_y);
+	*x_mm = (int16_t) (origin_x + ((long) column * plan_block * 2 + plan_block) * GRID_CELL / 2);
+	*y_mm = (int16_t) (origin_y + ((long) row * plan_block * 2 + plan_block) * GRID_CELL / 2);
+}
+
+/**
+*	This method ends the plan
+*	@param	status	PLAN_IDLE .. PLAN_OUTSIDE
+*	@date	10/17/2026
+*/
+static void plan_finish(uint8_t status)
+{
+	plan_last.status = status;
+	plan_last.ms = (unsigned int) (clock_ms() - plan_began);
+	plan_last.points = status == PLAN_FOUND || status == PLAN_PARTIAL ? pursuit_points() : 0;
+	plan_last.plans++;
+}
+
+/**
+*	This method starts running down the wave from the robot
+*	@date	10/17/2026
+*/
+static void plan_trace_begin(void)
+{
+	plan_phase = PLAN_PHASE_TRACE;
+	plan_column = plan_robot_column;
+	plan_row = plan_robot_row;
+	plan_anchor_x = plan_last_x = plan_robot_x;
+	plan_anchor_y = plan_last_y = plan_robot_y;
+	pursuit_clear();
+}
+
+/**
+*	This method starts the wave at the goal, from what the grid holds now
+*	@date	10/17/2026
+*/
+static void plan_search_begin(void)
+{
+	memset(plan_wave, 0, sizeof(plan_wave));
+	plan_set(plan_goal_column, plan_goal_row, 1);
+	plan_last.reached = 1;
+	plan_last.waves = 0;
+	plan_column = 0;
+	plan_row = 0;
+	plan_grew = 0;
+	plan_grid = grid_changes();
+	plan_phase = PLAN_PHASE_SEARCH;
+	if (plan_goal_column == plan_robot_column && plan_goal_row == plan_robot_row)
+		plan_trace_begin();
+}
+
+/**
+*	This method spreads the wave. Each pass over the cells moves the front
+*	one step: every cell of the front marks the free neighbours not reached
+*	yet. A front from 3 steps back has none left, so mod 3 is enough to tell
+*	the front. Scanning needs no queue, and the work per call is bounded.
+*	@param	budget	Work left in this call, used up by the search
+*	@date	10/17/2026
+*/
+static void plan_search(int16_t *budget)
+{
+	uint8_t size = GRID_SIZE / plan_block;
+	uint8_t front = plan_last.waves % 3 + 1;
+	uint8_t next = front % 3 + 1;
+	uint8_t column, row, near_column, near_row, k;
+
+	while (*budget > 0)
+	{
+		if (plan_row == size)
+		{
+			/// A front that reached nothing new: the robot is walled off
+			if (!plan_grew)
+			{
+				plan_finish(PLAN_UNREACHABLE);
+				return;
+			}
+			plan_last.waves++;
+			plan_row = 0;
+			plan_grew = 0;
+			front = next;
+			next = front % 3 + 1;
+		}
+
+		(*budget)--;
+		column = plan_column;
+		row = plan_row;
+		if (++plan_column == size)
+		{
+			plan_column = 0;
+			plan_row++;
+		}
+		if (plan_get(column, row) != front)
+			continue;
+
+		for (k = 0; k < 4; k++)
+		{
+			/// Off the left or the bottom wraps to 255, past the size
+			near_column = column + plan_dx[k];
+			near_row = row + plan_dy[k];
+			if (near_column >= size || near_row >= size || plan_get(near_column, near_row))
+				continue;
+			/// The robot's own cell is always taken, even close to a wall
+			if (near_column == plan_robot_column && near_row == plan_robot_row)
+			{
+				plan_set(near_column, near_row, next);
+				plan_last.reached++;
+				plan_last.waves++;
+				plan_trace_begin();
+				return;
+			}
+			*budget -= (plan_block + 2) * (plan_block + 2);
+			if (!plan_room(near_column, near_row))
+				continue;
+			plan_set(near_column, near_row, next);
+			plan_last.reached++;
+			plan_grew = 1;
+		}
+	}
+}
+
+/**
+*	This method runs down the wave from the robot to the goal, one step a
+*	cell, and keeps only the waypoints where the straight line from the last
+*	one would no longer clear what the grid has seen
+*	@param	budget	Work left in this call, used up by the trace
+*	@date	10/17/2026
+*/
+static void plan_trace(int16_t *budget)
+{
+	uint8_t size = GRID_SIZE / plan_block;
+	uint8_t down, k, near_column = 0, near_row = 0;
+	int16_t x, y;
+
+	while (*budget > 0)
+	{
+		if (plan_column == plan_goal_column && plan_row == plan_goal_row)
+		{
+			if ((plan_anchor_x != plan_goal_x || plan_anchor_y != plan_goal_y) && !pursuit_add(plan_goal_x, plan_goal_y))
+				plan_finish(PLAN_PARTIAL);
+			else
+				plan_finish(PLAN_FOUND);
+			return;
+		}
+
+		/// The neighbour one step closer to the goal
+		down = plan_get(plan_column, plan_row);
+		down = down == 1 ? 3 : down - 1;
+		for (k = 0; k < 4; k++)
+		{
+			near_column = plan_column + plan_dx[k];
+			near_row = plan_row + plan_dy[k];
+			if (near_column < size && near_row < size && plan_get(near_column, near_row) == down)
+				break;
+		}
+		plan_column = near_column;
+		plan_row = near_row;
+		/// The goal itself rather than the middle of its cell
+		if (plan_column == plan_goal_column && plan_row == plan_goal_row)
+		{
+			x = plan_goal_x;
+			y = plan_goal_y;
+		}
+		else
+			plan_center(plan_column, plan_row, &x, &y);
+
+		*budget -= PLAN_LINE_COST;
+		if (grid_line_blocked(plan_anchor_x, plan_anchor_y, x, y, PLAN_CLEARANCE))
+		{
+			/// Blocked right at the robot: step out cell by cell
+			if (plan_last_x == plan_anchor_x && plan_last_y == plan_anchor_y)
+			{
+				plan_last_x = x;
+				plan_last_y = y;
+			}
+			if (!pursuit_add(plan_last_x, plan_last_y))
+			{
+				plan_finish(PLAN_PARTIAL);
+				return;
+			}
+			plan_anchor_x = plan_last_x;
+			plan_anchor_y = plan_last_y;
+		}
+		plan_last_x = x;
+		plan_last_y = y;
+	}
+}
+
+/**
+*	This method sets the size of a planner cell for the next plan
+*	@param	mm		Rounded to whole grid cells
+*	@date	10/17/2026
+*/
+void plan_set_cell(int16_t mm)
+{
+	int16_t block = (mm + GRID_CELL / 2) / GRID_CELL;
+
+	plan_block_next = (uint8_t) MIN(MAX(block, PLAN_BLOCK_MIN), PLAN_BLOCK_MAX);
+}
+
+/**
+*	This method returns the size of a planner cell
+*	@return	mm
+*	@date	10/17/2026
+*/
+int16_t plan_cell(void)
+{
+	return plan_block_next * GRID_CELL;
+}
+
+/**
+*	This method starts planning a way from the robot to a goal
+*	@param	x_mm	x of the goal in mm
+*	@param	y_mm	y of the goal in mm
+*	@return	0 if the robot or the goal is off the grid, or the goal was seen
+*			occupied
+*	@date	10/17/2026
+*/
+uint8_t plan_start(int16_t x_mm, int16_t y_mm)
+{
+	odom_pose_t pose;
+
+	odom_get(&pose);
+	plan_robot_x = ODOM_MM(pose.x);
+	plan_robot_y = ODOM_MM(pose.y);
+	plan_goal_x = x_mm;
+	plan_goal_y = y_mm;
+	plan_block = plan_block_next;
+
+	plan_began = clock_ms();
+	plan_last.size = GRID_SIZE / plan_block;
+	plan_last.reached = 0;
+	plan_last.waves = 0;
+	plan_last.ticks = 0;
+	plan_last.restarts = 0;
+	if (!plan_locate(plan_goal_x, plan_goal_y, &plan_goal_column, &plan_goal_row)
+		|| !plan_locate(plan_robot_x, plan_robot_y, &plan_robot_column, &plan_robot_row))
+	{
+		plan_finish(PLAN_OUTSIDE);
+		return 0;
+	}
+	/// A goal on something the sweeps saw cannot be reached
+	if (grid_at(plan_goal_x, plan_goal_y) >= GRID_SEEN)
+	{
+		plan_finish(PLAN_UNREACHABLE);
+		return 0;
+	}
+	plan_last.status = PLAN_BUSY;
+	plan_search_begin();
+	return 1;
+}
+
+/**
+*	This method does a bounded part of the plan
+*	@return	PLAN_BUSY until the plan is done, then how it went
+*	@date	10/17/2026
+*/
+uint8_t plan_service(void)
+{
+	int16_t budget = PLAN_BUDGET;
+
+	if (plan_last.status != PLAN_BUSY)
+		return plan_last.status;
+	plan_last.ticks++;
+
+	/// A sweep saw something new, which the wave may run through
+	if (grid_changes() != plan_grid)
+	{
+		plan_last.restarts++;
+		plan_search_begin();
+	}
+	if (plan_phase == PLAN_PHASE_SEARCH)
+		plan_search(&budget);
+	if (plan_last.status == PLAN_BUSY && plan_phase == PLAN_PHASE_TRACE)
+		plan_trace(&budget);
+	return plan_last.status;
+}
+
+/**
+*	This method gives up the plan under way
+*	@date	10/17/2026
+*/
+void plan_cancel(void)
+{
+	if (plan_last.status == PLAN_BUSY)
+		plan_finish(PLAN_IDLE);
+}
+
+/**
+*	This method returns the last plan
+*	@return	the last plan, or the one under way
+*	@date	10/17/2026
+*/
+const plan_result_t *plan_result(void)
+{
+	return &plan_last;
+}
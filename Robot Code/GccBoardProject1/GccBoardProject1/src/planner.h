@@ -0,0 +1,71 @@
+/**
+*	@file	planner.h
+*	@brief	Wavefront planner over the occupancy grid. A breadth first wave
+*			spreads from the goal around what the grid has seen until it
+*			reaches the robot, a bounded amount of work per call so the main
+*			loop keeps polling, and the robot then runs down the wave to the
+*			goal. The path comes out as pure pursuit waypoints.
+*	@date	10/17/2026
+*/
+
+#ifndef PLANNER_H
+#define PLANNER_H
+
+#include <inttypes.h>
+#include "grid.h"
+
+/// Grid cells per side of a planner cell; coarser plans are quicker
+#define PLAN_BLOCK_DEFAULT	2
+#define PLAN_BLOCK_MIN		2	// the wave of 32 x 32 cells takes 256 bytes
+#define PLAN_BLOCK_MAX		8
+/// mm the straight lines between waypoints keep from what the grid has seen
+#define PLAN_CLEARANCE GRID_CELL
+
+/// How a plan went
+#define PLAN_IDLE			0
+#define PLAN_BUSY			1
+#define PLAN_FOUND			2	// the path ends at the goal
+#define PLAN_PARTIAL		3	// the path turns too often to fit and stops short
+#define PLAN_UNREACHABLE	4	// the goal was seen occupied, or the wave died out
+#define PLAN_OUTSIDE		5	// the robot or the goal is off the grid
+
+/// The last plan, and how long it took
+typedef struct {
+	unsigned int plans;		// plans finished since reset
+	uint8_t status;			// PLAN_IDLE .. PLAN_OUTSIDE
+	uint8_t size;			// planner cells per side
+	uint16_t reached;		// cells the wave reached
+	uint16_t waves;			// steps from the goal, the wave's last front
+	uint16_t ticks;			// calls of plan_service() it took
+	unsigned int ms;		// from plan_start() to the end
+	uint8_t points;			// waypoints of the path
+	uint8_t restarts;		// started over because the grid changed
+} plan_result_t;
+
+/// \brief Set the size of a planner cell
+/// \param mm rounded to whole grid cells, PLAN_BLOCK_MIN .. PLAN_BLOCK_MAX
+void plan_set_cell(int16_t mm);
+
+/// \return size of a planner cell in mm
+int16_t plan_cell(void);
+
+/// \brief Start planning a way from the robot to a goal. Replaces what is
+/// planned, and on success the pursuit path.
+/// \param x_mm x of the goal in the odometry frame
+/// \param y_mm y of the goal in the odometry frame
+/// \return 0 if the robot or the goal is off the grid, or the goal was seen
+/// occupied
+uint8_t plan_start(int16_t x_mm, int16_t y_mm);
+
+/// \brief Do a bounded part of the plan. Starts over when the grid changes.
+/// Once it is done the pursuit path holds the waypoints; see path_start().
+/// \return PLAN_BUSY until the plan is done, then how it went
+uint8_t plan_service(void);
+
+/// \brief Give up the plan under way
+void plan_cancel(void);
+
+/// \return the last plan, or the one under way
+const plan_result_t *plan_result(void);
+
+#endif
@@ -0,0 +1,298 @@
+/**
+*	@file	pursuit.c
+*	@brief	Fixed-point pure pursuit along a polyline.
+*	@date	10/17/2026
+*/
+
+#include <stdlib.h>
+#include "util.h"
+#include "open_interface.h"
+#include "odometry.h"
+#include "pursuit.h"
+
+/// Half the distance between the wheels of the Create in mm
+#define PURSUIT_HALF_BASE 129
+/// Tightest curvature: pivot on the inner wheel, which never runs backwards
+#define PURSUIT_CURVATURE_MAX ((1L << PURSUIT_Q) / PURSUIT_HALF_BASE)
+
+/// Point 0 is where the robot started; segment i runs from point i to i + 1
+static int16_t pursuit_x[PURSUIT_MAX + 1];
+static int16_t pursuit_y[PURSUIT_MAX + 1];
+static uint16_t pursuit_length[PURSUIT_MAX];
+static uint8_t pursuit_count = 0;
+static int16_t pursuit_ahead = PURSUIT_LOOKAHEAD_DEFAULT;
+
+/// Segment the robot is on, and mm along it to the point nearest the robot
+static uint8_t pursuit_segment = 0;
+static long pursuit_along = 0;
+/// Robot position (mm) and heading at the last update
+static int16_t pursuit_robot_x = 0;
+static int16_t pursuit_robot_y = 0;
+static uint16_t pursuit_heading = 0;
+static int16_t pursuit_kappa = 0;
+
+/**
+*	This method returns the integer square root
+*	@param	value	Number to take the root of
+*	@return	floor(sqrt(value))
+*	@date	10/17/2026
+*/
+static uint16_t pursuit_sqrt(uint32_t value)
+{
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > value)
+		bit >>= 2;
+	while (bit)
+	{
+		if (value >= root + bit)
+		{
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+			root >>= 1;
+		bit >>= 2;
+	}
+	return (uint16_t) root;
+}
+
+/**
+*	This method starts a new path
+*	@date	10/17/2026
+*/
+void pursuit_clear(void)
+{
+	pursuit_count = 0;
+}
+
+/**
+*	This method adds a point to the path
+*	@param	x_mm	x of the point in mm
+*	@param	y_mm	y of the point in mm
+*	@return	0 if the path is full
+*	@date	10/17/2026
+*/
+uint8_t pursuit_add(int16_t x_mm, int16_t y_mm)
+{
+	if (pursuit_count == PURSUIT_MAX)
+		return 0;
+	pursuit_count++;
+	pursuit_x[pursuit_count] = x_mm;
+	pursuit_y[pursuit_count] = y_mm;
+	return 1;
+}
+
+/**
+*	This method returns the number of points in the path
+*	@return	points, not counting where the robot starts
+*	@date	10/17/2026
+*/
+uint8_t pursuit_points(void)
+{
+	return pursuit_count;
+}
+
+/**
+*	This method reads a point of the path
+*	@param	index	1 for the first point added
+*	@param	x_mm	Where to store x in mm
+*	@param	y_mm	Where to store y in mm
+*	@date	10/17/2026
+*/
+void pursuit_point(uint8_t index, int16_t *x_mm, int16_t *y_mm)
+{
+	*x_mm = pursuit_x[index];
+	*y_mm = pursuit_y[index];
+}
+
+/**
+*	This method returns the point the robot drives toward
+*	@return	index of the end of the segment the robot is on
+*	@date	10/17/2026
+*/
+uint8_t pursuit_next(void)
+{
+	return pursuit_segment + 1;
+}
+
+/**
+*	This method sets the lookahead distance
+*	@param	mm		How far ahead along the path to aim
+*	@date	10/17/2026
+*/
+void pursuit_set_lookahead(int16_t mm)
+{
+	pursuit_ahead = MAX(PURSUIT_LOOKAHEAD_MIN, MIN(mm, PURSUIT_LOOKAHEAD_MAX));
+}
+
+/**
+*	This method returns the lookahead distance
+*	@return	mm
+*	@date	10/17/2026
+*/
+int16_t pursuit_lookahead(void)
+{
+	return pursuit_ahead;
+}
+
+/**
+*	This method starts following the path from the robot's position
+*	@return	length of the path in mm, or -1 if longer than PURSUIT_LENGTH_MAX
+*	@date	10/17/2026
+*/
+long pursuit_begin(void)
+{
+	odom_pose_t pose;
+	long dx, dy, total = 0;
+	uint8_t i;
+
+	odom_get(&pose);
+	pursuit_x[0] = ODOM_MM(pose.x);
+	pursuit_y[0] = ODOM_MM(pose.y);
+	for (i = 0; i < pursuit_count; i++)
+	{
+		dx = (long) pursuit_x[i + 1] - pursuit_x[i];
+		dy = (long) pursuit_y[i + 1] - pursuit_y[i];
+		/// Within the limit dx * dx + dy * dy fits a long, and the
+		/// products of the steps with a length fit one too
+		if (labs(dx) > PURSUIT_LENGTH_MAX || labs(dy) > PURSUIT_LENGTH_MAX)
+			return -1;
+		pursuit_length[i] = pursuit_sqrt((uint32_t) (dx * dx + dy * dy));
+		total += pursuit_length[i];
+	}
+	if (total > PURSUIT_LENGTH_MAX)
+		return -1;
+	pursuit_segment = 0;
+	pursuit_along = 0;
+	pursuit_kappa = 0;
+	return total;
+}
+
+/**
+*	This method finds where along the path the robot is
+*	@return	mm of path left; negative once past the end
+*	@date	10/17/2026
+*/
+long pursuit_update(void)
+{
+	odom_pose_t pose;
+	long rx, ry, remaining;
+	uint8_t i;
+
+	if (!pursuit_count)
+		return 0;
+
+	odom_get(&pose);
+	pursuit_robot_x = ODOM_MM(pose.x);
+	pursuit_robot_y = ODOM_MM(pose.y);
+	pursuit_heading = pose.heading;
+
+	/// Project the robot onto its segment; once past the end of it, go on
+	/// to the next. Never back, so a path that crosses itself still works.
+	while (1)
+	{
+		i = pursuit_segment;
+		rx = (long) pursuit_robot_x - pursuit_x[i];
+		ry = (long) pursuit_robot_y - pursuit_y[i];
+		pursuit_along = pursuit_length[i] ? (rx * (pursuit_x[i + 1] - pursuit_x[i])
+			+ ry * (pursuit_y[i + 1] - pursuit_y[i])) / pursuit_length[i] : 0;
+		if (pursuit_along < pursuit_length[i] || i + 1 >= pursuit_count)
+			break;
+		pursuit_segment++;
+	}
+	if (pursuit_along < 0)
+		pursuit_along = 0;
+
+	remaining = (long) pursuit_length[pursuit_segment] - pursuit_along;
+	for (i = pursuit_segment + 1; i < pursuit_count; i++)
+		remaining += pursuit_length[i];
+	return remaining;
+}
+
+/**
+*	This method steers toward the lookahead point
+*	@param	speed	Wheel speed on a straight path in mm/s
+*	@param	right	Where to store the right wheel speed
+*	@param	left	Where to store the left wheel speed
+*	@date	10/17/2026
+*/
+void pursuit_steer(int16_t speed, int16_t *right, int16_t *left)
+{
+	long need = pursuit_along + pursuit_ahead;
+	long dx, dy, ahead, side, distance2, kappa, turn;
+	uint8_t i = pursuit_segment;
+	uint8_t shift = 0;
+	int16_t goal_x, goal_y, cos_h, sin_h;
+
+	if (!pursuit_count)
+	{
+		*right = 0;
+		*left = 0;
+		return;
+	}
+
+	/// The goal point: lookahead mm on along the path, or its end
+	while (need > pursuit_length[i] && i + 1 < pursuit_count)
+	{
+		need -= pursuit_length[i];
+		i++;
+	}
+	if (need > pursuit_length[i])
+		need = pursuit_length[i];
+	goal_x = pursuit_x[i];
+	goal_y = pursuit_y[i];
+	if (pursuit_length[i])
+	{
+		goal_x += (int16_t) (need * (pursuit_x[i + 1] - pursuit_x[i]) / pursuit_length[i]);
+		goal_y += (int16_t) (need * (pursuit_y[i + 1] - pursuit_y[i]) / pursuit_length[i]);
+	}
+
+	/// The goal in the robot's frame: ahead of it and to its left
+	dx = (long) goal_x - pursuit_robot_x;
+	dy = (long) goal_y - pursuit_robot_y;
+	cos_h = odom_cos(pursuit_heading);
+	sin_h = odom_sin(pursuit_heading);
+	ahead = (dx * cos_h + dy * sin_h) >> ODOM_TRIG_Q;
+	side = (dy * cos_h - dx * sin_h) >> ODOM_TRIG_Q;
+
+	/// The arc through the robot and the goal has curvature 2 side / d^2.
+	/// A goal far off is scaled down until side * 2^17 and d^2 fit a long,
+	/// and the curvature scaled back up by as much.
+	while (labs(ahead) > 8191 || labs(side) > 8191)
+	{
+		ahead /= 2;
+		side /= 2;
+		shift++;
+	}
+	distance2 = ahead * ahead + side * side;
+	/// A goal behind the robot gets the tightest turn toward it
+	if (ahead < 0)
+		kappa = side < 0 ? -PURSUIT_CURVATURE_MAX : PURSUIT_CURVATURE_MAX;
+	else
+		kappa = distance2 ? (side * (2L << PURSUIT_Q) / distance2) >> shift : 0;
+	if (kappa > PURSUIT_CURVATURE_MAX)
+		kappa = PURSUIT_CURVATURE_MAX;
+	if (kappa < -PURSUIT_CURVATURE_MAX)
+		kappa = -PURSUIT_CURVATURE_MAX;
+	pursuit_kappa = (int16_t) kappa;
+
+	/// Slower on tight curves: halved at PURSUIT_SLOW_RADIUS
+	speed = (int16_t) (((long) speed << PURSUIT_Q) / ((1L << PURSUIT_Q) + PURSUIT_SLOW_RADIUS * labs(kappa)));
+
+	/// The outer wheel runs faster by half the wheel base times the curvature
+	turn = ((long) speed * kappa * PURSUIT_HALF_BASE) >> PURSUIT_Q;
+	*right = (int16_t) (speed + turn);
+	*left = (int16_t) (speed - turn);
+}
+
+/**
+*	This method returns the curvature of the last steer
+*	@return	1/mm in Q16, positive to the left
+*	@date	10/17/2026
+*/
+int16_t pursuit_curvature(void)
+{
+	return pursuit_kappa;
+}
@@ -0,0 +1,75 @@
+/**
+*	@file	pursuit.h
+*	@brief	Pure pursuit along a polyline in the odometry frame, in fixed
+*			point. Each step steers toward the point a lookahead distance
+*			further along the path, on the arc that reaches it, so the robot
+*			rounds the corners instead of stopping at them.
+*	@date	10/17/2026
+*/
+
+#ifndef PURSUIT_H
+#define PURSUIT_H
+
+#include <inttypes.h>
+
+/// Most points in a path, not counting where the robot starts
+#define PURSUIT_MAX 15
+/// How far ahead along the path the robot aims, in mm
+#define PURSUIT_LOOKAHEAD_DEFAULT	300
+#define PURSUIT_LOOKAHEAD_MIN		50
+#define PURSUIT_LOOKAHEAD_MAX		2000
+/// Longest path in mm; the motion that follows it counts mm in an int
+#define PURSUIT_LENGTH_MAX 32000
+/// Fractional bits of a curvature in 1/mm (Q16)
+#define PURSUIT_Q 16
+/// On a curve of this radius (mm) the speed is halved; tighter, slower still
+#define PURSUIT_SLOW_RADIUS 250
+
+/// \brief Start a new path at the robot's position
+void pursuit_clear(void);
+
+/// \brief Add a point to the path
+/// \param x_mm x of the point in the odometry frame
+/// \param y_mm y of the point in the odometry frame
+/// \return 0 if the path is full
+uint8_t pursuit_add(int16_t x_mm, int16_t y_mm);
+
+/// \return points in the path, not counting where the robot starts
+uint8_t pursuit_points(void);
+
+/// \brief Read a point of the path
+/// \param index 1 for the first point added .. pursuit_points()
+/// \param x_mm where to store x
+/// \param y_mm where to store y
+void pursuit_point(uint8_t index, int16_t *x_mm, int16_t *y_mm);
+
+/// \return index of the point the robot drives toward, see pursuit_point()
+uint8_t pursuit_next(void);
+
+/// \brief Set how far ahead along the path the robot aims. Shorter follows
+/// the corners closer; longer is smoother.
+/// \param mm the lookahead distance, PURSUIT_LOOKAHEAD_MIN .. PURSUIT_LOOKAHEAD_MAX
+void pursuit_set_lookahead(int16_t mm);
+
+/// \return the lookahead distance in mm
+int16_t pursuit_lookahead(void);
+
+/// \brief Follow the path from where the robot is now
+/// \return length of the path in mm, or -1 if it is longer than
+/// PURSUIT_LENGTH_MAX
+long pursuit_begin(void);
+
+/// \brief Find where along the path the robot is, from the odometry pose
+/// \return mm of path left; negative once past the end
+long pursuit_update(void);
+
+/// \brief Steer toward the lookahead point found by pursuit_update()
+/// \param speed wheel speed on a straight path in mm/s; curves get less
+/// \param right where to store the right wheel speed in mm/s
+/// \param left where to store the left wheel speed in mm/s
+void pursuit_steer(int16_t speed, int16_t *right, int16_t *left);
+
+/// \return curvature of the last steer in 1/mm, Q16, positive to the left
+int16_t pursuit_curvature(void);
+
+#endif
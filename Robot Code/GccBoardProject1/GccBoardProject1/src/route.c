@@ -0,0 +1,409 @@
+/**
+*	@file	route.c
+*	@brief	Queue of moves, turns, arcs and waypoints run back to back.
+*	@date	10/17/2026
+*/
+
+#include <stdlib.h>
+#include <math.h>
+#include "open_interface.h"
+#include "movement.h"
+#include "odometry.h"
+#include "pursuit.h"
+#include "grid.h"
+#include "planner.h"
+#include "route.h"
+
+/// A waypoint closer than this (mm) is driven to without turning first
+#define ROUTE_NEAR 20
+/// mm a waypoint's straight line keeps from what the grid has seen
+#define ROUTE_CLEARANCE 150
+/// Plans one waypoint may take before it gives up
+#define ROUTE_REPLANS 4
+
+/// Ring of waiting steps
+static route_step_t route_steps[ROUTE_MAX];
+static uint8_t route_head = 0;
+static uint8_t route_count = 0;
+static uint16_t route_next_id = 1;
+/// The step the stepped motion runs for the queue, if any
+static route_step_t route_active;
+static uint8_t route_running = 0;
+/// Set while a waypoint turns toward the point, before it drives there
+static uint8_t route_leg = 0;
+/// Status the step ends with though no motion ended it: a waypoint with no
+/// way there, or a plan flushed before it was driven; 0 if none
+static uint8_t route_ended = 0;
+/// Set while the planner looks for a way around, while the robot drives it,
+/// and when the way was cancelled to plan it again
+static uint8_t route_planning = 0;
+static uint8_t route_detour = 0;
+static uint8_t route_replan = 0;
+/// Plans the waypoint took so far
+static uint8_t route_replans = 0;
+/// grid_changes() when the way to the waypoint was last checked
+static uint8_t route_grid = 0;
+
+/**
+*	This method adds a step to the end of the queue
+*	@param	kind	ROUTE_MOVE .. ROUTE_PATH
+*	@param	a		First argument, see ROUTE_MOVE .. ROUTE_PATH
+*	@param	b		Second argument
+*	@param	speed	Speed in mm/s
+*	@return	the id of the step, or 0 if the queue is full
+*	@date	10/17/2026
+*/
+uint16_t route_append(uint8_t kind, int16_t a, int16_t b, int16_t speed)
+{
+	route_step_t *step;
+
+	if (route_count == ROUTE_MAX)
+		return 0;
+
+	step = &route_steps[(route_head + route_count) % ROUTE_MAX];
+	step->id = route_next_id++;
+	step->kind = kind;
+	step->a = a;
+	step->b = b;
+	step->speed = speed;
+	route_count++;
+
+	/// 0 means "not queued"
+	if (route_next_id == 0)
+		route_next_id = 1;
+	return step->id;
+}
+
+/**
+*	This method queues a batch of steps written as text
+*	@param	line	The batch, e.g. "m500;t90;v150;g1000,500"
+*	@param	speed	Speed of the steps before the first v, in mm/s
+*	@param	first	Where to store the id of the first step queued
+*	@return	number of steps queued
+*	@date	10/17/2026
+*/
+uint8_t route_parse(const char *line, int16_t speed, uint16_t *first)
+{
+	const char *next = line;
+	char *end;
+	char letter;
+	long args[2] = {0, 0};
+	uint8_t count = 0;
+	uint8_t n, kind, needed;
+	uint16_t id;
+
+	*first = 0;
+	while (1)
+	{
+		while (*next == ';' || *next == ' ')
+			next++;
+		if (!*next)
+			break;
+		letter = *next++;
+
+		for (n = 0; n < 2; n++)
+		{
+			args[n] = strtol(next, &end, 10);
+			if (end == next)
+				break;
+			next = end;
+			if (*next != ',')
+			{
+				n++;
+				break;
+			}
+			next++;
+		}
+
+		needed = 1;
+		switch (letter)
+		{
+			case 'v':
+				/// A move at 0 mm/s would never get to its goal
+				if (n != 1 || (int16_t) args[0] <= 0)
+					return count;
+				speed = (int16_t) args[0];
+				continue;
+			case 'l':
+				if (n != 1)
+					return count;
+				pursuit_set_lookahead((int16_t) args[0]);
+				continue;
+			case 'c':
+				if (n != 1)
+					return count;
+				plan_set_cell((int16_t) args[0]);
+				continue;
+			case 'm':
+				kind = ROUTE_MOVE;
+				break;
+			case 't':
+				kind = ROUTE_TURN;
+				break;
+			case 'h':
+				kind = ROUTE_HEADING;
+				break;
+			case 'a':
+				kind = ROUTE_ARC;
+				needed = 2;
+				break;
+			case 'g':
+				kind = ROUTE_GOTO;
+				needed = 2;
+				break;
+			case 'p':
+				kind = ROUTE_PATH;
+				needed = 2;
+				break;
+			default:
+				return count;
+		}
+		/// Also for the speed the batch came with
+		if (n != needed || speed <= 0)
+			return count;
+		/// An arc needs a radius
+		if (kind == ROUTE_ARC && (int16_t) args[0] == 0)
+			return count;
+
+		id = route_append(kind, (int16_t) args[0], (int16_t) args[1], speed);
+		if (!id)
+			return count;
+		if (!count)
+			*first = id;
+		count++;
+	}
+	return count;
+}
+
+/**
+*	This method empties the queue
+*	@return	number of waiting steps dropped
+*	@date	10/17/2026
+*/
+uint8_t route_flush(void)
+{
+	uint8_t dropped = route_count;
+
+	route_count = 0;
+	/// route_service() reports the running step as cancelled
+	if (route_planning)
+	{
+		plan_cancel();
+		route_planning = 0;
+		route_ended = MOTION_CANCELLED;
+	}
+	route_replan = 0;
+	if (route_running)
+		motion_cancel();
+	return dropped;
+}
+
+/**
+*	This method returns the number of waiting steps
+*	@return	steps waiting, not counting the running one
+*	@date	10/17/2026
+*/
+uint8_t route_queued(void)
+{
+	return route_count;
+}
+
+/**
+*	This method drives a waypoint: first turns toward the point, then drives
+*	the distance odometry gives once the turn is over. If the grid knows of
+*	something in the way, it plans a way around instead; see route_service().
+*	After a detour it drives what is left, straight or planned again.
+*	@date	10/17/2026
+*/
+static void route_goto(void)
+{
+	odom_pose_t pose;
+	long dx, dy;
+	int distance;
+	uint8_t detour = route_detour;
+
+	odom_get(&pose);
+	dx = (long) route_active.a - ODOM_MM(pose.x);
+	dy = (long) route_active.b - ODOM_MM(pose.y);
+	distance = (int) (sqrt((double) dx * dx + (double) dy * dy) + 0.5);
+	route_detour = 0;
+	route_grid = grid_changes();
+
+	/// The detour ended on the waypoint
+	if (detour && distance < ROUTE_NEAR)
+		return;
+	if (grid_line_blocked(ODOM_MM(pose.x), ODOM_MM(pose.y), route_active.a, route_active.b, ROUTE_CLEARANCE))
+	{
+		route_leg = 0;
+		if (route_replans == ROUTE_REPLANS || !plan_start(route_active.a, route_active.b))
+		{
+			route_ended = MOTION_STOPPED;
+			return;
+		}
+		route_replans++;
+		route_planning = 1;
+		return;
+	}
+	if (!route_leg && distance >= ROUTE_NEAR)
+	{
+		route_leg = 1;
+		turn_to_heading_start((int) floor(atan2((double) dy, (double) dx) * 180.0 / M_PI + 0.5), route_active.speed);
+		return;
+	}
+	route_leg = 0;
+	move_start(distance, route_active.speed);
+}
+
+/**
+*	This method starts the motion of the active step
+*	@date	10/17/2026
+*/
+static void route_start(void)
+{
+	switch (route_active.kind)
+	{
+		case ROUTE_MOVE:
+			move_start(route_active.a, route_active.speed);
+			break;
+		case ROUTE_TURN:
+			turn_start(route_active.a, route_active.speed);
+			break;
+		case ROUTE_HEADING:
+			turn_to_heading_start(route_active.a, route_active.speed);
+			break;
+		case ROUTE_ARC:
+			arc_turn_start(route_active.a, route_active.b, route_active.speed);
+			break;
+		case ROUTE_GOTO:
+			route_leg = 0;
+			route_replans = 0;
+			route_goto();
+			break;
+		case ROUTE_PATH:
+			/// Points queued in a row make one path, driven without stopping
+			pursuit_clear();
+			pursuit_add(route_active.a, route_active.b);
+			while (route_count && route_steps[route_head].kind == ROUTE_PATH && pursuit_points() < PURSUIT_MAX)
+			{
+				pursuit_add(route_steps[route_head].a, route_steps[route_head].b);
+				route_head = (route_head + 1) % ROUTE_MAX;
+				route_count--;
+			}
+			path_start(route_active.speed);
+			break;
+	}
+}
+
+/**
+*	This method checks the rest of the way to a waypoint against the grid:
+*	the straight line, or what is left of the planned path
+*	@return	1 if something was seen in the way
+*	@date	10/17/2026
+*/
+static uint8_t route_way_blocked(void)
+{
+	odom_pose_t pose;
+	int16_t x, y, next_x, next_y;
+	uint8_t i;
+
+	route_grid = grid_changes();
+	odom_get(&pose);
+	x = ODOM_MM(pose.x);
+	y = ODOM_MM(pose.y);
+	if (!route_detour)
+		return grid_line_blocked(x, y, route_active.a, route_active.b, ROUTE_CLEARANCE);
+
+	for (i = pursuit_next(); i <= pursuit_points(); i++)
+	{
+		pursuit_point(i, &next_x, &next_y);
+		if (grid_line_blocked(x, y, next_x, next_y, PLAN_CLEARANCE))
+			return 1;
+		x = next_x;
+		y = next_y;
+	}
+	return 0;
+}
+
+/**
+*	This method starts the next step once the last motion is over
+*	@param	event	Where to store what happened
+*	@return	1 if there is an event to report
+*	@date	10/17/2026
+*/
+uint8_t route_service(route_event_t *event)
+{
+	uint8_t status = motion_status();
+	uint8_t plan;
+
+	if (status == MOTION_RUNNING)
+	{
+		/// A sweep saw something new on the way: stop and plan again
+		if (route_running && route_active.kind == ROUTE_GOTO && grid_changes() != route_grid && route_way_blocked())
+		{
+			route_replan = 1;
+			motion_cancel();
+		}
+		return 0;
+	}
+
+	if (route_running)
+	{
+		/// A little more of the plan each call, so the sensors keep being read
+		if (route_planning)
+		{
+			plan = plan_service();
+			if (plan == PLAN_BUSY)
+				return 0;
+			route_planning = 0;
+			route_detour = 1;
+			route_grid = grid_changes();
+			/// No path when the robot is in the waypoint's own cell already
+			if ((plan == PLAN_FOUND || plan == PLAN_PARTIAL) && path_start(route_active.speed))
+				return 0;
+			route_detour = 0;
+			route_ended = MOTION_STOPPED;
+		}
+		else if (route_replan && status == MOTION_CANCELLED)
+		{
+			route_replan = 0;
+			route_leg = 0;
+			route_detour = 0;
+			route_goto();
+		}
+		else if ((route_leg || route_detour) && status == MOTION_DONE)
+			route_goto();
+		if (!route_ended && (route_planning || motion_status() == MOTION_RUNNING))
+			return 0;
+
+		/// The waypoint has no way there, as if a hazard had stopped it
+		if (route_ended)
+		{
+			status = route_ended;
+			route_ended = 0;
+		}
+		route_running = 0;
+		route_leg = 0;
+		route_detour = 0;
+		/// Whatever stopped this step would stop the next one too
+		if (status != MOTION_DONE)
+			route_count = 0;
+		event->id = route_active.id;
+		event->status = status;
+		event->queued = route_count;
+		return 1;
+	}
+
+	if (!route_count)
+		return 0;
+
+	route_active = route_steps[route_head];
+	route_head = (route_head + 1) % ROUTE_MAX;
+	route_count--;
+	route_running = 1;
+	route_start();
+
+	event->id = route_active.id;
+	event->status = ROUTE_STARTED;
+	event->queued = route_count;
+	return 1;
+}
@@ -0,0 +1,77 @@
+/**
+*	@file	route.h
+*	@brief	Queue of moves, turns, arcs and waypoints that the robot runs back
+*			to back on its own. The host sends a whole batch in one message
+*			instead of a key per motion, and can add to it or flush it while
+*			it runs.
+*	@date	10/17/2026
+*/
+
+#ifndef ROUTE_H
+#define ROUTE_H
+
+#include <inttypes.h>
+
+/// What a step does with its two arguments
+#define ROUTE_MOVE		0	// a: mm, negative backs up
+#define ROUTE_TURN		1	// a: degrees, counterclockwise positive
+#define ROUTE_HEADING	2	// a: absolute heading in degrees
+#define ROUTE_ARC		3	// a: radius in mm, positive to the left; b: degrees
+#define ROUTE_GOTO		4	// a, b: x and y in mm, in the odometry frame; plans a
+							// way around what the grid has seen in the way, and
+							// plans again when a sweep sees more
+#define ROUTE_PATH		5	// a, b: a point of a path followed with pure pursuit;
+							// the points after it in a row join the same path
+/// Most steps waiting in the queue
+#define ROUTE_MAX		16
+/// Started event; the others carry the MOTION_ status the step ended with
+#define ROUTE_STARTED	1
+
+/// One queued step
+typedef struct {
+	uint16_t id;		// numbered in the order they were queued, from 1
+	uint8_t kind;		// ROUTE_MOVE .. ROUTE_PATH
+	int16_t a;
+	int16_t b;
+	int16_t speed;		// mm/s
+} route_step_t;
+
+/// Progress of the queue, from route_service()
+typedef struct {
+	uint16_t id;		// step the event is about
+	uint8_t status;		// ROUTE_STARTED, MOTION_DONE, _STOPPED or _CANCELLED
+	uint8_t queued;		// steps still waiting after this one
+} route_event_t;
+
+/// \brief Add a step to the end of the queue
+/// \return the id of the step, or 0 if the queue is full
+uint16_t route_append(uint8_t kind, int16_t a, int16_t b, int16_t speed);
+
+/// \brief Queue a batch written as letters and numbers, separated by ';':
+/// m<mm>, t<deg>, h<deg>, a<radius>,<deg> (radius not 0), g<x>,<y>, p<x>,<y> and v<speed>,
+/// which sets the speed of the steps after it, above 0. l<mm> sets the lookahead of
+/// the paths and c<mm> the cell size of the plans right away. Parsing stops
+/// at the first bad step.
+/// \param line the batch, without the newline
+/// \param speed mm/s of the steps before the first v
+/// \param first where to store the id of the first step queued
+/// \return number of steps queued
+uint8_t route_parse(const char *line, int16_t speed, uint16_t *first);
+
+/// \brief Drop every waiting step and cancel the one running
+/// \return number of steps dropped, not counting the running one
+uint8_t route_flush(void);
+
+/// \return steps waiting, not counting the running one
+uint8_t route_queued(void);
+
+/// \brief Start the next step once the last motion is over. Call after
+/// motion_step(); call again while it returns 1, since a step can end and
+/// the next start in one go. A step that was stopped or cancelled flushes
+/// the queue, so the robot does not go on after a hazard or an 'x'. While
+/// a waypoint plans its way, each call does a bounded part of the plan.
+/// \param event where to store what happened
+/// \return 1 if there is an event to report
+uint8_t route_service(route_event_t *event);
+
+#endif
@@ -0,0 +1,162 @@
+/**
+*	@file	safety.c
+*	@brief	Reflex stop for bumpers, wheel drops, cliffs and the boundary line.
+*	@date	10/17/2026
+*/
+
+#include <avr/interrupt.h>
+#include "util.h"
+#include "open_interface.h"
+#include "drive.h"
+#include "movement.h"
+#include "safety.h"
+
+static uint8_t safety_checks = SAFETY_ALL;
+/// Hazards in the last frame
+static volatile uint8_t safety_present = 0;
+/// Hazards waiting for their stop, and clock_ms() of the frame of the first.
+/// A hazard waits as long as it is there, so one the robot already stands
+/// at still stops it once it is told to drive into it. Written by the
+/// receive interrupt while streaming.
+static volatile uint8_t safety_waiting = 0;
+static volatile unsigned long safety_time = 0;
+/// Set while safety_service() runs, since the stop itself may wait
+static uint8_t safety_busy = 0;
+static safety_t safety_state = {0, 0, 0, 0, 0};
+
+/**
+*	This method chooses which hazards stop the robot
+*	@param	checks	Mask of SAFETY_BUMPER .. SAFETY_LINE
+*	@date	10/17/2026
+*/
+void safety_enable(uint8_t checks)
+{
+	safety_checks = checks;
+}
+
+/**
+*	This method finds the hazards in a frame
+*	@param	frame	Sensor frame
+*	@return	mask of the enabled hazards present
+*	@date	10/17/2026
+*/
+uint8_t safety_hazards(const oi_t *frame)
+{
+	uint8_t hazards = 0;
+
+	if (frame->bumper_left || frame->bumper_right)
+		hazards |= SAFETY_BUMPER;
+	if (frame->wheeldrop_left || frame->wheeldrop_right || frame->wheeldrop_caster)
+		hazards |= SAFETY_WHEELDROP;
+	if (frame->cliff_left || frame->cliff_frontleft || frame->cliff_frontright || frame->cliff_right)
+		hazards |= SAFETY_CLIFF;
+	if ((frame->cliff_frontleft_signal > SAFETY_LINE_LEFT_MIN && frame->cliff_frontleft_signal < SAFETY_LINE_MAX)
+		|| (frame->cliff_frontright_signal > SAFETY_LINE_RIGHT_MIN && frame->cliff_frontright_signal < SAFETY_LINE_MAX))
+		hazards |= SAFETY_LINE;
+
+	return hazards & safety_checks;
+}
+
+/**
+*	This method checks a frame as it is published
+*	@param	frame	The complete frame
+*	@param	time_ms	clock_ms() the frame came in
+*	@date	10/17/2026
+*/
+void safety_check(const oi_t *frame, unsigned long time_ms)
+{
+	uint8_t hazards = safety_hazards(frame);
+
+	safety_present = hazards;
+	safety_state.frames++;
+	if (!hazards)
+		return;
+
+	/// Latency counts from the first hazard still waiting
+	if (!safety_waiting)
+		safety_time = time_ms;
+	safety_waiting |= hazards;
+}
+
+/**
+*	This method stops the robot for a hazard, once it drives toward it
+*	@date	10/17/2026
+*/
+void safety_service(void)
+{
+	uint8_t cause, sreg;
+	unsigned long since, latency;
+	int16_t right, left, right_target, left_target;
+	uint8_t moving;
+
+	if (!safety_waiting || safety_busy)
+		return;
+	safety_busy = 1;
+
+	sreg = SREG;
+	cli();
+	cause = safety_waiting;
+	since = safety_time;
+	safety_waiting = 0;
+	SREG = sreg;
+
+	/// A wheel drop stops anything; the front hazards only stop the robot
+	/// while it goes forward or turns, so backing away from them still works.
+	/// A wheel told to go forward counts before it ramps up.
+	drive_setpoints(&right, &left);
+	drive_targets(&right_target, &left_target);
+	if (cause & SAFETY_WHEELDROP)
+		moving = right != 0 || left != 0 || right_target != 0 || left_target != 0;
+	else
+		moving = right > 0 || left > 0 || right_target > 0 || left_target > 0;
+	if (motion_status() == MOTION_RUNNING || motion_script_status() == MOTION_SCRIPT_RUNNING)
+		moving = 1;
+
+	/// Docking drives into the home base on purpose
+	if (moving && oi_dock()->status != OI_DOCK_SEEKING)
+	{
+		motion_cancel();
+		motion_script_abort();
+		drive_set_now(0, 0);
+
+		latency = clock_ms() - since;
+		safety_state.trips++;
+		safety_state.cause = cause;
+		safety_state.last_ms = latency;
+		if (latency > safety_state.worst_ms)
+			safety_state.worst_ms = latency;
+	}
+	else
+	{
+		/// Not moving toward it: the hazards still there wait for the next
+		/// command, and the latency then counts from this look
+		sreg = SREG;
+		cli();
+		safety_waiting |= cause & safety_present;
+		if (safety_waiting)
+			safety_time = clock_ms();
+		SREG = sreg;
+	}
+
+	safety_busy = 0;
+}
+
+/**
+*	This method tells whether a stop is due
+*	@return	1 while a hazard waits for its stop
+*	@date	10/17/2026
+*/
+uint8_t safety_pending(void)
+{
+	return safety_waiting != 0;
+}
+
+/**
+*	This method returns the reflex counters
+*	@return	the counters
+*	@date	10/17/2026
+*/
+const safety_t *safety(void)
+{
+	return &safety_state;
+}
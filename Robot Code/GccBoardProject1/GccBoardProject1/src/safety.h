@@ -0,0 +1,65 @@
+/**
+*	@file	safety.h
+*	@brief	Reflex stop for bumpers, wheel drops, cliffs and the boundary
+*			line. Every sensor frame is checked as it is published, from the
+*			stream interrupt or a poll, whatever the main loop is doing; a
+*			hazard stops the robot at the next safe point once it drives
+*			toward it, also when the hazard was there before it set off.
+*	@date	10/17/2026
+*/
+
+#ifndef SAFETY_H
+#define SAFETY_H
+
+#include <inttypes.h>
+#include "open_interface.h"
+
+/// Hazards, as a mask
+#define SAFETY_BUMPER		0x01
+#define SAFETY_WHEELDROP	0x02
+#define SAFETY_CLIFF		0x04
+#define SAFETY_LINE			0x08
+#define SAFETY_ALL			0x0F
+
+/// The boundary line reads between these front cliff signals; the same
+/// thresholds the movement() checks use
+#define SAFETY_LINE_LEFT_MIN	500
+#define SAFETY_LINE_RIGHT_MIN	700
+#define SAFETY_LINE_MAX			2000
+
+/// Reflex counters
+typedef struct {
+	unsigned int frames;		// frames checked
+	unsigned int trips;			// stops the reflex made
+	uint8_t cause;				// hazards behind the last stop
+	unsigned int last_ms;		// from the hazard's frame to the last stop
+	unsigned int worst_ms;		// the longest of those
+} safety_t;
+
+/// \brief Choose which hazards stop the robot; all of them by default
+/// \param checks mask of SAFETY_BUMPER .. SAFETY_LINE
+void safety_enable(uint8_t checks);
+
+/// \return hazards present in a frame, of those enabled
+uint8_t safety_hazards(const oi_t *frame);
+
+/// \brief Check a frame as it is published. Called by the open interface for
+/// every frame, from the receive interrupt while streaming. Only notes the
+/// hazards present; the stop is sent by safety_service().
+/// \param frame the complete frame
+/// \param time_ms clock_ms() the frame came in
+void safety_check(const oi_t *frame, unsigned long time_ms);
+
+/// \brief Stop the robot if it drives toward a hazard seen since the last
+/// call. Cancels stepped and script motions; hazards still present wait for
+/// the next command while the robot stands or backs away. Called by oi_update(), oi_update_list() and
+/// wait_ms(); must not be called between the bytes of a command.
+void safety_service(void);
+
+/// \return 1 while a hazard waits for its stop
+uint8_t safety_pending(void);
+
+/// \return the reflex counters
+const safety_t *safety(void);
+
+#endif
@@ -1,471 +1,925 @@
-/**
- *	@file util.c
- *
- *	util.c: utility functions for the Atmel platform
- *	For an overview of how timer based interrupts work, see
- *	page 111 and 133-137 of the Atmel Mega128 User Guide
- *
- *  @brief This file holds all utility functions for using the
- *	Timer, Shaft Encoder, Robot Push Buttons, Stepper Motor, 
- *	USART Serial Communication, and User Interface movement
- *
- *	@author Zhao Zhang, Chad Nelson and Robert Guetzlaff
- *	@date 06/26/2012
- */
-
-#include <avr/io.h>
-#include <avr/interrupt.h>
-#include "util.h"
-#include "open_interface.h"
-#include "lcd.h"
-#include "sweep.h"
-#include "string.h"
-#include "stdio.h"
-#include "movement.h"
-
-#define TIMER_PRESCALER 8
-#define CLOCK_SPEED 16000000
-#define SOUND_SPEED 34000
-
-/// Global used for interrupt driven delay functions
-volatile unsigned int timer2_tick;
-void timer2_start(char unit);
-void timer2_stop(void);
-
-/**
-*	This method blocks for a specified number of milliseconds.
-*	@author		Robert Guetzlaff
-*	@param		time_val		The amount of time in milliseconds to block
-*	@date		7/6/2016
-*/
-void wait_ms(unsigned int time_val) 
-{
-	/// Setting OC value for time requested
-	/// Clock is 16 MHz. At a pre-scaler of 64, 250 timer ticks = 1ms.
-	OCR2 = 250; 				
-	timer2_tick = 0;
-	timer2_start(0);
-	//Waiting for time
-	while(timer2_tick < time_val){};
-	timer2_stop();
-}
-
-/**
-*	This method starts Timer 2
-*	@author		Robert Guetzlaff
-*	@param		unit		Speed for Timer 2
-*	@date		7/6/2016
-*/
-void timer2_start(char unit) {
-	timer2_tick = 0;
-	/// Unit = 0 is for slow 
-	if ( unit == 0 ) 
-	{ 		
-		/// WGM:CTC, COM:OC2 disconnected, pre-scaler = 64
-        TCCR2 = 0b00001011;	
-		/// Enabling O.C. Interrupt for Timer2
-        TIMSK |= 0b10000000;	
-	}
-	/// Unit = 1 is for fast
-	if (unit == 1) 
-	{ 		
-		/// WGM:CTC, COM:OC2 disconnected, pre-scaler = 1
-        TCCR2 = 0b00001001;
-		/// Enabling O.C. Interrupt for Timer2	
-        TIMSK |= 0b10000000;	
-	}
-	sei();
-}
-
-/**
-*	This method stops Timer 2
-*	@author		Robert Guetzlaff
-*	@date		7/6/2016
-*/
-void timer2_stop(void) 
-{
-	/// Disabling O.C. Interrupt for Timer2
-	TIMSK &= ~0b10000000;		
-	/// Clearing O.C. settings
-	TCCR2 &= 0b01111111;		
-}
-
-// 
-/**
-*	This method is an interrupt handler 
-*	@author		Robert Guetzlaff
-*	@param		TIMER2_COMP_vect		This interrupt rises every 1 ms
-*	@date		7/6/2016
-*/
-ISR (TIMER2_COMP_vect) 
-{
-	timer2_tick++;
-}
-
-/**
-*	This method initializes PORTC to accept push buttons as input
-*	@author		Nicus Hicks
-*	@date		7/6/2016
-*/
-void init_push_buttons(void) 
-{
-	/// Setting PC0-PC5 to input
-	DDRC &= 0xC0; 
-	/// Setting pins' pull up resistors 
-	PORTC |= 0x3F; 
-}
-
-/// Return the position of button being pushed
-/**
- *	Return the position of button being pushed.
- *	@return the position of the button being pushed.  
- *	A 1 is the rightmost button.  0 indicates no button being pressed
- */
-char read_push_buttons(void) 
-{
-	return 0;
-}
-
-/**
-*	This method initializes PORTC for input from the shaft encoder
-*	@author		Robert Guetzlaff
-*	@date		7/6/2016
-*/
-void shaft_encoder_init(void) 
-{
-	/// Setting PC6-PC7 to input
-	DDRC &= 0x3F;	
-	/// Setting pins' pull-up resistors
-	PORTC |= 0xC0;	
-}
-
-/// Read the shaft encoder
-/**
- *	Reads the two switches of the shaft encoder and compares the values
- *	to the previous read.  This function should be called very frequently
- *	for the best results.
- *
- *	@return a value indicating the shaft encoder has moved:
- *	0 = no rotation (switches did not change)
- *	1 = CW rotation
- *	-1 = CCW rotation
- */
-char read_shaft_encoder(void) 
-{
-	return 0;
-}
-
-/**
-*	This method initializes PORTE to control the stepper motor
-*	@author		Nicus Hicks
-*	@date		7/6/2016
-*/
-void stepper_init(void) 
-{
-	/// Setting PE4-PE7 to output
-	DDRE |= 0xF0;  	
-	/// Initial position (0b1000) PE4-PE7
-	PORTE &= 0x8F;  
-	wait_ms(2);
-	/// Clear PE4-PE7
-	PORTE &= 0x0F;  
-}
-
-/// Turn the Stepper Motor
-/**
- *	Turn the stepper motor a given number of steps. 
- *
- *	@param		num_steps	A value between 1 and 200 steps (1.8 to 360 degrees)
- *	@param		direction	Indication of direction: 1 for CW and -1 for CCW 
- */
-void  move_stepper_motor_by_step(int num_steps, int direction) 
-{
-}
-
-/**
-*	This method transmits data through serial communication with the Robot
-*	@author Robert Guetzlaff
-*	@param	sensor		Oi sensor to transmit data
-*	@param	speed		Speed at which to transmite the data
-*	@date	7/6/2016
-*/
-void transmit_data(oi_t* sensor, int speed)
-{
-	char output[100];
-	oi_update(sensor);
-	
-	sprintf(output, "BL,%d\n", sensor->bumper_left);
-	serial_puts(output);
-	
-	wait_ms(1);
-	
-	sprintf(output, "BR,%d\n", sensor->bumper_right);
-	serial_puts(output);
-	
-	wait_ms(1);
-	
-	sprintf(output, "CL,%d\n", sensor->cliff_frontleft);
-	serial_puts(output);
-	
-	wait_ms(1);
-	
-	sprintf(output, "CR,%d\n", sensor->cliff_frontright);
-	serial_puts(output);
-	
-	wait_ms(1);
-	
-	sprintf(output, "LL,%d\n", sensor->cliff_frontleft_signal);
-	serial_puts(output);
-	
-	wait_ms(1);
-	
-	sprintf(output, "LR,%d\n", sensor->cliff_frontright_signal);
-	serial_puts(output);
-	
-	wait_ms(1);
-	
-	sprintf(output, "S,%d\n", speed);
-	serial_puts(output);
-	
-	wait_ms(1);
-	
-	serial_puts("END\n");
-}
-
-/**
-*	This method initializes serial communication with the Robot
-*	@author		Robert Guetzlaff
-*	@date		7/6/2016
-*/
-void serial_init(void)
-{
-	/// Set the baud rate
-	unsigned int baud = 34;
-	UBRR0H = (unsigned char) (baud >> 8);
-	UBRR0L = (unsigned char) baud;
-	
-	/// Initializes the USART's
-	UCSR0A = 0b00000010;
-	UCSR0C = 0b00001110;
-	UCSR0B = 0b00011000;
-}
-
-/**
-*	This method gets a character via serial communication
-*	@author		Robert Guetzlaff
-*	@return		Char received from the USART
-*	@date		7/6/2016
-*/
-char serial_getc(void)
-{
-	/// Wait for the receive complete flag(RXC)
-	while((UCSR0A & 0b10000000) == 0);
-	return UDR0;
-}
-
-/**
-*	This method transmits a character via serial communication
-*	@author		Robert Guetzlaff
-*	@param		data	Char to transmit with the USART
-*	@date		7/6/2016
-*/
-void serial_putc(char data)
-{
-	while((UCSR0A & 0b00100000) == 0){}
-	UDR0 = data;
-}
-
-/**
-*	This method transmits a string via serial communication
-*	@author		Robert Guetzlaff
-*	@param		data	Char array to transmit with the USART
-*	@date		7/6/2016
-*/
-void serial_puts(char* data){	int i = 0;	while(data[i] != '\0' && data[i] != 0)	{		serial_putc(data[i]);		i++;	}	serial_putc('\r');	serial_putc('\n');}
-
-/**
-*	This method moves the Robot using the User Interface provided with the application
-*	@author		Robert Guetzlaff
-*	@param		sensor	Instance of oi_t, used to move the robot
-*	@date		7/6/2016
-*/
-void movement(oi_t* sensor)
-{
-	int speed = 100;
-	/// Output variable for printing the speed
-	
-	/// Current value coming in from serial communication
-	char cur_val = 0;
-	/// Number of loops it has received the same input
-	int count = 0;
-	/// String for outputing data
-	char output[50];
-	
-	
-	while(1)
-	{
-		//oi_update(sensor);
-		//lprintf("%d %d %d %d", sensor->cliff_left_signal, sensor->cliff_frontleft_signal, sensor->cliff_frontright_signal, sensor->cliff_right_signal);
-		//lprintf("%d", sensor->angle);
-		//sprintf(speed_reading, "Current speed is set to %d", speed);
-		/// Manual checks the register instead of using serial_getc() 
-		while(((UCSR0A & 0b10000000) != 0))
-		{
-			/// Pull data out of the register
-			cur_val = UDR0;
-			
-			/// Checking what was transmitted and moving the Robot accordingly
-			if(cur_val == 'w')
-			{
-				oi_set_wheels(speed, speed);
-				count++;
-			}
-			if(cur_val == 's')
-			{
-				oi_set_wheels(-speed, -speed);
-				count++;
-			}
-			if(cur_val == 'a')
-			{
-				oi_set_wheels(speed, -speed);
-				oi_update(sensor);
-				sprintf(output, "anglen,%d", sensor->angle);
-				serial_puts(output);
-			}
-			if(cur_val == 'd')
-			{
-				//Positive angle
-				oi_set_wheels(-speed, speed);
-				oi_update(sensor);
-				sprintf(output, "anglep,%d", sensor->angle);
-				serial_puts(output);
-			}
-			if(cur_val == '+')
-			{
-				speed += 25;
-				count++;
-			}
-			if(cur_val == '-')
-			{
-				speed -= 25;
-				count++;
-			}
-			if(cur_val == 'p') oi_play_song(1);
-			if(cur_val == 32)
-			{
-				sweep();
-				transmit_data(sensor,speed);
-			}
-			if(cur_val == 'e')
-			{
-				turn(sensor, 270, speed);
-			}
-			if(cur_val == 'q')
-			{
-				turn(sensor, 90, speed);
-			}
-			if(cur_val == 'z')
-			{
-				careMove(sensor, 20, 100);
-			}
-			
-			oi_update(sensor);
-			sprintf(output, "%u, %u, %u, %u", sensor->cliff_left_signal, sensor->cliff_frontleft_signal, sensor->cliff_frontright_signal, sensor->cliff_right_signal);
-			serial_puts(output);
-			/// Checking for cliff impact
-			/// If the robot runs into a cliff, it reverse for 5 seconds
-			if(sensor->bumper_left)
-			{
-				oi_set_wheels(-50,-50);
-				serial_puts("W,Left Impact");
-				wait_ms(5000);
-				break;
-			}
-			if(sensor->bumper_right)
-			{
-				oi_set_wheels(-50,-50);
-				serial_puts("W,Right Impact");
-				wait_ms(5000);
-				break;
-			}
-			if(sensor->cliff_frontleft)
-			{
-				oi_set_wheels(-50,-50);
-				serial_puts("W,Cliff left");
-				wait_ms(5000);
-				break;
-			}
-			if(sensor->cliff_frontright)
-			{
-				oi_set_wheels(-50,-50);
-				serial_puts("W,Cliff right");
-				wait_ms(5000);
-				break;
-			}
-			///Checking for the line boundary
-			///If a boundary is found, it reverses
-			if(sensor->cliff_frontleft_signal > 500 && sensor->cliff_frontleft_signal < 2000)
-			{
-				oi_set_wheels(-50, -50);
-				serial_puts("W,line front left");
-				wait_ms(50);
-				break;
-			}
-			if(sensor->cliff_frontright_signal > 700  && sensor->cliff_frontright_signal < 2000)
-			{
-				oi_set_wheels(-50, -50);
-				serial_puts("W,line front right");
-				wait_ms(50);
-				break;
-			}
-			if(sensor->cliff_left > 500  && sensor->cliff_left < 2000)
-			{
-				oi_set_wheels(-50, -50);
-				serial_puts("W,line left signal");
-				wait_ms(50);
-				break;
-			}
-			if(sensor->cliff_right > 500  && sensor->cliff_right < 2000)
-			{
-				oi_set_wheels(-50, -50);
-				serial_puts("W,line right signal");
-				wait_ms(50);
-				break;
-			}
-			if(sensor->cliff_right_signal < 120)
-			{
-				oi_play_song(1);
-				serial_puts("WIN");
-				oi_set_wheels(0,0);
-				//wait_ms(10000);
-			}
-			if(sensor->cliff_frontleft_signal < 120)
-			{
-				oi_play_song(1);
-				serial_puts("WIN");
-				oi_set_wheels(0,0);
-				//wait_ms(10000);
-			}
-// 			if(sensor->cliff_frontright_signal < 0)
-// 			{
-// 				oi_play_song(1);
-// 				serial_puts("WIN");
-// 				oi_set_wheels(0,0);
-// 				wait_ms(10000);
-// 			}
-			if(sensor->cliff_left_signal < 120)
-			{
-				oi_play_song(1);
-				serial_puts("WIN");
-				oi_set_wheels(0,0);
-				//wait_ms(10000);
-			}
-			oi_update(sensor);
-			
-			wait_ms(10);
-		}
-		//serial_getc();
-		oi_set_wheels(0,0);
-		count = 0;
-	}
+/**
+ *	@file util.c
+ *
+ *	util.c: utility functions for the Atmel platform
+ *	For an overview of how timer based interrupts work, see
+ *	page 111 and 133-137 of the Atmel Mega128 User Guide
+ *
+ *  @brief This file holds all utility functions for using the
+ *	Timer, Shaft Encoder, Robot Push Buttons, Stepper Motor, 
+ *	USART Serial Communication, and User Interface movement
+ *
+ *	@author Zhao Zhang, Chad Nelson and Robert Guetzlaff
+ *	@date 06/26/2012
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "util.h"
+#include "open_interface.h"
+#include "lcd.h"
+#include "sweep.h"
+#include "string.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "movement.h"
+#include "odometry.h"
+#include "drive.h"
+#include "battery.h"
+#include "heading.h"
+#include "safety.h"
+#include "route.h"
+#include "grid.h"
+#include "planner.h"
+
+#define TIMER_PRESCALER 8
+#define CLOCK_SPEED 16000000
+#define SOUND_SPEED 34000
+/// A drive key holds its speed this long (ms); the UI repeats a held key
+/// every 50 ms, so the robot ramps to a stop only once the key is let go
+#define MANUAL_REPEAT_MS 150
+/// Speeds + and - step between, in mm/s; the motions cannot run at 0
+#define MANUAL_SPEED_MIN 25
+#define MANUAL_SPEED_MAX 500
+/// Degrees either side of straight ahead (90 in a sweep) an object may be
+/// for a detour, which is planned as if it were dead ahead
+#define DETOUR_CONE_DEG 10
+
+/// Global used for interrupt driven delay functions
+volatile unsigned int timer2_tick;
+/// Milliseconds counted by Timer 0 since clock_init()
+volatile unsigned long clock_ticks = 0;
+void timer2_start(char unit);
+void timer2_stop(void);
+
+/**
+*	This method blocks for a specified number of milliseconds.
+*	@author		Robert Guetzlaff
+*	@param		time_val		The amount of time in milliseconds to block
+*	@date		7/6/2016
+*/
+void wait_ms(unsigned int time_val) 
+{
+	/// Setting OC value for time requested
+	/// Clock is 16 MHz. At a pre-scaler of 64, 250 timer ticks = 1ms.
+	OCR2 = 250; 				
+	timer2_tick = 0;
+	timer2_start(0);
+	//Waiting for time; a hazard from the stream still gets its stop
+	while(timer2_tick < time_val)
+	{
+		safety_service();
+	}
+	timer2_stop();
+}
+
+/**
+*	This method starts Timer 2
+*	@author		Robert Guetzlaff
+*	@param		unit		Speed for Timer 2
+*	@date		7/6/2016
+*/
+void timer2_start(char unit) {
+	timer2_tick = 0;
+	/// Unit = 0 is for slow 
+	if ( unit == 0 ) 
+	{ 		
+		/// WGM:CTC, COM:OC2 disconnected, pre-scaler = 64
+        TCCR2 = 0b00001011;	
+		/// Enabling O.C. Interrupt for Timer2
+        TIMSK |= 0b10000000;	
+	}
+	/// Unit = 1 is for fast
+	if (unit == 1) 
+	{ 		
+		/// WGM:CTC, COM:OC2 disconnected, pre-scaler = 1
+        TCCR2 = 0b00001001;
+		/// Enabling O.C. Interrupt for Timer2	
+        TIMSK |= 0b10000000;	
+	}
+	sei();
+}
+
+/**
+*	This method stops Timer 2
+*	@author		Robert Guetzlaff
+*	@date		7/6/2016
+*/
+void timer2_stop(void) 
+{
+	/// Disabling O.C. Interrupt for Timer2
+	TIMSK &= ~0b10000000;		
+	/// Clearing O.C. settings
+	TCCR2 &= 0b01111111;		
+}
+
+// 
+/**
+*	This method is an interrupt handler 
+*	@author		Robert Guetzlaff
+*	@param		TIMER2_COMP_vect		This interrupt rises every 1 ms
+*	@date		7/6/2016
+*/
+ISR (TIMER2_COMP_vect) 
+{
+	timer2_tick++;
+}
+
+/**
+*	This method starts Timer 0 as a free running millisecond clock
+*	@date		10/17/2026
+*/
+void clock_init(void)
+{
+	/// Clock is 16 MHz. At a pre-scaler of 64, 250 timer ticks = 1ms.
+	OCR0 = 249;
+	/// WGM:CTC, COM:OC0 disconnected, pre-scaler = 64
+	TCCR0 = 0b00001100;
+	/// Enabling O.C. Interrupt for Timer0
+	TIMSK |= 0b00000010;
+	sei();
+}
+
+/**
+*	This method returns the milliseconds since clock_init()
+*	@return		Milliseconds counted by Timer 0
+*	@date		10/17/2026
+*/
+unsigned long clock_ms(void)
+{
+	unsigned long ticks;
+	/// The 4 byte counter must not change while it is read
+	uint8_t sreg = SREG;
+	cli();
+	ticks = clock_ticks;
+	SREG = sreg;
+	return ticks;
+}
+
+/**
+*	This method is the interrupt handler for the millisecond clock
+*	@param		TIMER0_COMP_vect		This interrupt rises every 1 ms
+*	@date		10/17/2026
+*/
+ISR (TIMER0_COMP_vect)
+{
+	clock_ticks++;
+}
+
+/**
+*	This method initializes PORTC to accept push buttons as input
+*	@author		Nicus Hicks
+*	@date		7/6/2016
+*/
+void init_push_buttons(void) 
+{
+	/// Setting PC0-PC5 to input
+	DDRC &= 0xC0; 
+	/// Setting pins' pull up resistors 
+	PORTC |= 0x3F; 
+}
+
+/// Return the position of button being pushed
+/**
+ *	Return the position of button being pushed.
+ *	@return the position of the button being pushed.  
+ *	A 1 is the rightmost button.  0 indicates no button being pressed
+ */
+char read_push_buttons(void) 
+{
+	return 0;
+}
+
+/**
+*	This method initializes PORTC for input from the shaft encoder
+*	@author		Robert Guetzlaff
+*	@date		7/6/2016
+*/
+void shaft_encoder_init(void) 
+{
+	/// Setting PC6-PC7 to input
+	DDRC &= 0x3F;	
+	/// Setting pins' pull-up resistors
+	PORTC |= 0xC0;	
+}
+
+/// Read the shaft encoder
+/**
+ *	Reads the two switches of the shaft encoder and compares the values
+ *	to the previous read.  This function should be called very frequently
+ *	for the best results.
+ *
+ *	@return a value indicating the shaft encoder has moved:
+ *	0 = no rotation (switches did not change)
+ *	1 = CW rotation
+ *	-1 = CCW rotation
+ */
+char read_shaft_encoder(void) 
+{
+	return 0;
+}
+
+/**
+*	This method initializes PORTE to control the stepper motor
+*	@author		Nicus Hicks
+*	@date		7/6/2016
+*/
+void stepper_init(void) 
+{
+	/// Setting PE4-PE7 to output
+	DDRE |= 0xF0;  	
+	/// Initial position (0b1000) PE4-PE7
+	PORTE &= 0x8F;  
+	wait_ms(2);
+	/// Clear PE4-PE7
+	PORTE &= 0x0F;  
+}
+
+/// Turn the Stepper Motor
+/**
+ *	Turn the stepper motor a given number of steps. 
+ *
+ *	@param		num_steps	A value between 1 and 200 steps (1.8 to 360 degrees)
+ *	@param		direction	Indication of direction: 1 for CW and -1 for CCW 
+ */
+void  move_stepper_motor_by_step(int num_steps, int direction) 
+{
+}
+
+/**
+*	This method reads the rest of a command from the host, up to a newline
+*	@param	line	Where to store it, without the newline
+*	@param	size	Size of line; a longer command is cut short
+*	@date	10/17/2026
+*/
+static void read_line(char *line, uint8_t size)
+{
+	uint8_t i = 0;
+
+	while (i < size - 1 && (line[i] = serial_getc()) != '\n' && line[i] != '\r')
+		i++;
+	line[i] = 0;
+}
+
+/**
+*	This method reads new heading hold gains from the host, "kp,ki,kd" up to
+*	a newline. Gains left out keep their values.
+*	@date	10/17/2026
+*/
+static void heading_command(void)
+{
+	char line[24];
+	char output[32];
+	char *next = line;
+	char *end;
+	long value;
+	int16_t gains[3];
+	uint8_t i;
+
+	read_line(line, sizeof(line));
+
+	heading_get_gains(&gains[0], &gains[1], &gains[2]);
+	for (i = 0; i < 3 && *next; i++)
+	{
+		value = strtol(next, &end, 10);
+		if (end != next)
+			gains[i] = (int16_t) value;
+		next = end;
+		if (*next == ',')
+			next++;
+		else
+			break;
+	}
+	heading_set_gains(gains[0], gains[1], gains[2]);
+
+	sprintf(output, "HG,%d,%d,%d", gains[0], gains[1], gains[2]);
+	serial_puts(output);
+}
+
+/**
+*	This method transmits data through serial communication with the Robot
+*	@author Robert Guetzlaff
+*	@param	sensor		Oi sensor to transmit data
+*	@param	speed		Speed at which to transmite the data
+*	@date	7/6/2016
+*/
+void transmit_data(oi_t* sensor, int speed)
+{
+	char output[100];
+	odom_pose_t pose;
+	oi_update(sensor);
+	
+	sprintf(output, "BL,%d\n", sensor->bumper_left);
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	sprintf(output, "BR,%d\n", sensor->bumper_right);
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	sprintf(output, "CL,%d\n", sensor->cliff_frontleft);
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	sprintf(output, "CR,%d\n", sensor->cliff_frontright);
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	sprintf(output, "LL,%d\n", sensor->cliff_frontleft_signal);
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	sprintf(output, "LR,%d\n", sensor->cliff_frontright_signal);
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	sprintf(output, "S,%d\n", speed);
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	/// Odometry pose: mm and degrees from the starting point
+	odom_get(&pose);
+	sprintf(output, "PX,%d", ODOM_MM(pose.x));
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	sprintf(output, "PY,%d", ODOM_MM(pose.y));
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	sprintf(output, "PH,%d", odom_angle_to_deg(pose.heading));
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	/// Link to the Create: rate, failed rate changes and failed checks
+	sprintf(output, "LB,%lu,%u,%u", oi_link()->baud, oi_link()->baud_fallbacks, oi_link()->check_errors);
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	/// Sensor frames: good, dropped, corrupt, then framing, overrun and parity errors
+	sprintf(output, "LE,%u,%u,%u,%u,%u,%u", oi_link()->frames_good, oi_link()->frames_dropped, oi_link()->frames_corrupt,
+		oi_link()->framing_errors, oi_link()->overruns, oi_link()->parity_errors);
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	/// Battery: percent, mV, mA, minutes left at this draw, speed cap
+	sprintf(output, "BT,%u,%u,%d,%u,%u", battery_state()->percent, battery_state()->voltage, battery_state()->current,
+		battery_state()->minutes, battery_state()->speed_cap);
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	/// Wheel commands: sent, dropped as repeats, merged by the rate limit
+	sprintf(output, "LW,%u,%u,%u", oi_link()->wheels_sent, oi_link()->wheels_duplicates, oi_link()->wheels_merged);
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	/// Heading hold of the last straight move: degrees off, last trim in mm/s
+	sprintf(output, "HE,%d,%d", heading_error(), heading_correction());
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	sprintf(output, "RF,%u,%u,%u,%u", safety()->trips, safety()->cause, safety()->last_ms, safety()->worst_ms);
+	serial_puts(output);
+	
+	wait_ms(1);
+	
+	serial_puts("END\n");
+}
+
+/**
+*	This method initializes serial communication with the Robot
+*	@author		Robert Guetzlaff
+*	@date		7/6/2016
+*/
+void serial_init(void)
+{
+	/// Set the baud rate
+	unsigned int baud = 34;
+	UBRR0H = (unsigned char) (baud >> 8);
+	UBRR0L = (unsigned char) baud;
+	
+	/// Initializes the USART's
+	UCSR0A = 0b00000010;
+	UCSR0C = 0b00001110;
+	UCSR0B = 0b00011000;
+}
+
+/**
+*	This method gets a character via serial communication
+*	@author		Robert Guetzlaff
+*	@return		Char received from the USART
+*	@date		7/6/2016
+*/
+char serial_getc(void)
+{
+	/// Wait for the receive complete flag(RXC)
+	while((UCSR0A & 0b10000000) == 0);
+	return UDR0;
+}
+
+/**
+*	This method transmits a character via serial communication
+*	@author		Robert Guetzlaff
+*	@param		data	Char to transmit with the USART
+*	@date		7/6/2016
+*/
+void serial_putc(char data)
+{
+	while((UCSR0A & 0b00100000) == 0){}
+	UDR0 = data;
+}
+
+/**
+*	This method transmits a string via serial communication
+*	@author		Robert Guetzlaff
+*	@param		data	Char array to transmit with the USART
+*	@date		7/6/2016
+*/
+void serial_puts(char* data)
+{
+	int i = 0;
+	while(data[i] != '\0' && data[i] != 0)
+	{
+		serial_putc(data[i]);
+		i++;
+	}
+	serial_putc('\r');
+	serial_putc('\n');
+}
+
+/**
+*	This method follows a docking run and tells the host when it changes:
+*	DK,status,charging state,home base,seconds
+*	@param		sensor	Instance of oi_t, updated while docking
+*	@date		10/17/2026
+*/
+static void dock_service(oi_t* sensor)
+{
+	static oi_dock_t reported;
+	const oi_dock_t *dock;
+	char output[40];
+	
+	oi_dock_poll(sensor);
+	dock = oi_dock();
+	if(dock->status == reported.status && dock->charging_state == reported.charging_state && dock->home_base == reported.home_base)
+		return;
+	reported = *dock;
+	sprintf(output, "DK,%u,%u,%u,%lu", dock->status, dock->charging_state, dock->home_base, dock->elapsed_ms / 1000);
+	serial_puts(output);
+}
+
+/**
+*	This method advances a background move or turn by one step and tells the
+*	host when it ends: "MV,status,remaining,speed" with the MOTION_ status, the
+*	mm or degrees left once at rest (negative for an overshoot) and the speed
+*	@param		sensor	Instance of oi_t, updated while a motion runs
+*	@date		10/17/2026
+*/
+static void motion_service(oi_t* sensor)
+{
+	char output[32];
+	
+	if(motion_status() != MOTION_RUNNING)
+		return;
+	if(motion_step(sensor) == MOTION_RUNNING)
+		return;
+	sprintf(output, "MV,%u,%d,%d", motion_status(), motion_remaining(), motion_cruise_speed());
+	serial_puts(output);
+}
+
+/**
+*	This method queues a batch of motions the host sent after an 'r', e.g.
+*	"m500;t90;g1000,500" up to a newline; see route_parse(). Answers with
+*	"MA,first,count,queued": the id of the first step queued, how many were
+*	and how many wait now. A count short of the batch means it had a bad
+*	step or the queue is full.
+*	@param	speed	Speed of the steps that do not set their own, in mm/s
+*	@date	10/17/2026
+*/
+static void route_command(int speed)
+{
+	char line[96];
+	char output[32];
+	uint16_t first;
+	uint8_t count;
+	
+	read_line(line, sizeof(line));
+	count = route_parse(line, speed, &first);
+	sprintf(output, "MA,%u,%u,%u", first, count, route_queued());
+	serial_puts(output);
+}
+
+/**
+*	This method runs the motion queue and tells the host how it goes:
+*	"MQ,id,status,queued,x,y,heading" when a step starts (status 1) or ends
+*	(the MOTION_ status), with the steps still waiting and the pose in mm and
+*	degrees
+*	@date		10/17/2026
+*/
+static void route_report(void)
+{
+	route_event_t event;
+	odom_pose_t pose;
+	char output[48];
+	
+	while(route_service(&event))
+	{
+		odom_get(&pose);
+		sprintf(output, "MQ,%u,%u,%u,%d,%d,%d", event.id, event.status, event.queued,
+			ODOM_MM(pose.x), ODOM_MM(pose.y), odom_angle_to_deg(pose.heading));
+		serial_puts(output);
+	}
+}
+
+/**
+*	This method sends the occupancy grid to the host: "GM,size,cell,x,y"
+*	with the cells per side, their size and the corner of cell (0, 0) in mm,
+*	then "GR,row,cells" for each row with anything known, the cells in hex
+*	4 to a byte, column 0 in the low bits of the first byte, then "GE".
+*	Rows nobody has seen are left out.
+*	@date		10/17/2026
+*/
+static void grid_dump(void)
+{
+	uint8_t cells[GRID_ROW_BYTES];
+	char output[12 + 2 * GRID_ROW_BYTES];
+	int16_t x, y;
+	uint8_t row, i;
+	char *next;
+	
+	grid_origin(&x, &y);
+	sprintf(output, "GM,%u,%u,%d,%d", GRID_SIZE, GRID_CELL, x, y);
+	serial_puts(output);
+	for(row = 0; row < GRID_SIZE; row++)
+	{
+		if(!grid_row(row, cells))
+			continue;
+		next = output + sprintf(output, "GR,%u,", row);
+		for(i = 0; i < GRID_ROW_BYTES; i++)
+			next += sprintf(next, "%02X", cells[i]);
+		serial_puts(output);
+	}
+	serial_puts("GE");
+}
+
+/**
+*	This method tells the host how each plan of a waypoint went:
+*	"PN,status,size,reached,waves,ticks,ms,points,restarts" with the PLAN_
+*	status, the planner cells per side, the cells the wave reached, the steps
+*	from the goal to the robot, the calls and the time it took, the waypoints
+*	of the path and how often a sweep made it start over
+*	@date		10/17/2026
+*/
+static void plan_report(void)
+{
+	static unsigned int reported = 0;
+	char output[48];
+	const plan_result_t *plan = plan_result();
+	
+	if(plan->plans == reported)
+		return;
+	reported = plan->plans;
+	sprintf(output, "PN,%u,%u,%u,%u,%u,%u,%u,%u", plan->status, plan->size, plan->reached, plan->waves,
+		plan->ticks, plan->ms, plan->points, plan->restarts);
+	serial_puts(output);
+}
+
+/**
+*	This method tells the host when the safety reflex stopped the robot:
+*	"RF,trips,cause,last_ms,worst_ms" with the SAFETY_ hazards of the stop and
+*	the time from the hazard's frame to the stop, last and longest
+*	@date		10/17/2026
+*/
+static void reflex_report(void)
+{
+	static unsigned int reported = 0;
+	char output[40];
+	const safety_t *state = safety();
+	
+	if(state->trips == reported)
+		return;
+	reported = state->trips;
+	sprintf(output, "RF,%u,%u,%u,%u", state->trips, state->cause, state->last_ms, state->worst_ms);
+	serial_puts(output);
+}
+
+/**
+*	This method moves the Robot using the User Interface provided with the application
+*	@author		Robert Guetzlaff
+*	@param		sensor	Instance of oi_t, used to move the robot
+*	@date		7/6/2016
+*/
+void movement(oi_t* sensor)
+{
+	int speed = 100;
+	/// Output variable for printing the speed
+	
+	/// Current value coming in from serial communication
+	char cur_val = 0;
+	/// Number of loops it has received the same input
+	int count = 0;
+	/// String for outputing data
+	char output[50];
+	/// How wheel speeds reach the Create, DRIVE_MODE_VELOCITY or DRIVE_MODE_PWM
+	uint8_t drive_mode = DRIVE_MODE_VELOCITY;
+	/// clock_ms() until which the last drive key holds its speed
+	unsigned long manual_until = 0;
+	
+	
+	while(1)
+	{
+		//oi_update(sensor);
+		//lprintf("%d %d %d %d", sensor->cliff_left_signal, sensor->cliff_frontleft_signal, sensor->cliff_frontright_signal, sensor->cliff_right_signal);
+		//lprintf("%d", sensor->angle);
+		//sprintf(speed_reading, "Current speed is set to %d", speed);
+		/// Manual checks the register instead of using serial_getc() 
+		while(((UCSR0A & 0b10000000) != 0))
+		{
+			/// Pull data out of the register
+			cur_val = UDR0;
+			
+			/// Checking what was transmitted and moving the Robot accordingly
+			if(cur_val == 'w')
+			{
+				motion_cancel();
+				drive_set(speed, speed);
+				count++;
+				manual_until = clock_ms() + MANUAL_REPEAT_MS;
+			}
+			if(cur_val == 's')
+			{
+				motion_cancel();
+				drive_set(-speed, -speed);
+				count++;
+				manual_until = clock_ms() + MANUAL_REPEAT_MS;
+			}
+			if(cur_val == 'a')
+			{
+				motion_cancel();
+				drive_set(speed, -speed);
+				manual_until = clock_ms() + MANUAL_REPEAT_MS;
+				oi_update(sensor);
+				sprintf(output, "anglen,%d", sensor->angle);
+				serial_puts(output);
+			}
+			if(cur_val == 'd')
+			{
+				//Positive angle
+				motion_cancel();
+				drive_set(-speed, speed);
+				manual_until = clock_ms() + MANUAL_REPEAT_MS;
+				oi_update(sensor);
+				sprintf(output, "anglep,%d", sensor->angle);
+				serial_puts(output);
+			}
+			if(cur_val == '+')
+			{
+				speed = MIN(speed + 25, MANUAL_SPEED_MAX);
+				count++;
+			}
+			if(cur_val == '-')
+			{
+				speed = MAX(speed - 25, MANUAL_SPEED_MIN);
+				count++;
+			}
+			if(cur_val == 'p') oi_play_song(1);
+			if(cur_val == 32)
+			{
+				/// Scans are rationed when the battery runs low
+				if(battery_scan_allowed())
+				{
+					sweep();
+					transmit_data(sensor,speed);
+				}
+				else
+				{
+					sprintf(output, "W,Scan skipped, battery %u%%", battery_state()->percent);
+					serial_puts(output);
+					serial_puts("END\n");
+				}
+			}
+			/// Turns and short moves run in the background; x calls them off.
+			/// e and q turn right and left to the next quarter of the heading
+			/// odometry keeps, so repeated turns do not add up errors.
+			if(cur_val == 'e' || cur_val == 'q')
+			{
+				odom_pose_t pose;
+				
+				odom_get(&pose);
+				turn_to_heading_start(odom_angle_to_deg((pose.heading + ODOM_QUARTER_TURN / 2) & 0xC000) + (cur_val == 'q' ? 90 : -90), speed);
+			}
+			if(cur_val == 'z')
+			{
+				care_move_start(20, 100);
+			}
+			/// Dock and charge in the background; x calls it off
+			if(cur_val == 'g')
+			{
+				oi_dock_start(0);
+			}
+			/// A batch of motions to run back to back; f drops what is left
+			if(cur_val == 'r')
+			{
+				route_command(speed);
+			}
+			if(cur_val == 'f')
+			{
+				sprintf(output, "MF,%u", route_flush());
+				serial_puts(output);
+			}
+			/// The occupancy grid the sweeps filled in
+			if(cur_val == 'o')
+			{
+				grid_dump();
+			}
+			if(cur_val == 'x')
+			{
+				route_flush();
+				motion_cancel();
+				manual_until = clock_ms();
+				oi_dock_cancel();
+			}
+			/// PWM drive for slow, precise approaches; m toggles it
+			if(cur_val == 'm')
+			{
+				drive_mode = drive_mode == DRIVE_MODE_PWM ? DRIVE_MODE_VELOCITY : DRIVE_MODE_PWM;
+				drive_set_mode(drive_mode);
+				sprintf(output, "W,Drive mode %s", drive_mode == DRIVE_MODE_PWM ? "PWM" : "velocity");
+				serial_puts(output);
+			}
+			/// Swerve around the nearest object of the last scan, on the side away from it
+			if(cur_val == 'v')
+			{
+				int distance, width, degrees;
+				
+				if(!nearest_object(&distance, &width, &degrees))
+					serial_puts("W,No object to detour around");
+				else if(abs(degrees - 90) > DETOUR_CONE_DEG)
+				{
+					sprintf(output, "W,Object at %d degrees is not ahead", degrees);
+					serial_puts(output);
+				}
+				else if(!detour_start(distance * 10, width * 10, 100, degrees > 90 ? -1 : 1, speed))
+					serial_puts("W,No room for a detour");
+			}
+			/// Heading hold gains, Q8: k<kp>,<ki>,<kd> and a newline. Answers
+			/// with the gains in effect.
+			if(cur_val == 'k')
+			{
+				heading_command();
+			}
+			/// Step response of both modes at 100 mm/s; the robot moves about 30 cm
+			if(cur_val == 'b')
+			{
+				drive_step_t step;
+				uint8_t mode;
+
+				for (mode = DRIVE_MODE_VELOCITY; mode <= DRIVE_MODE_PWM; mode++)
+				{
+					drive_step_response(sensor, 100, mode, &step);
+					sprintf(output, "RT,%u,%d,%u,%u,%d", step.mode, step.speed, step.first_ms, step.rise_ms, step.peak);
+					serial_puts(output);
+					wait_ms(500);
+				}
+				drive_set_mode(drive_mode);
+			}
+			
+			oi_update(sensor);
+			sprintf(output, "%u, %u, %u, %u", sensor->cliff_left_signal, sensor->cliff_frontleft_signal, sensor->cliff_frontright_signal, sensor->cliff_right_signal);
+			serial_puts(output);
+			/// Checking for cliff impact
+			/// If the robot runs into a cliff, it reverse for 5 seconds
+			if(sensor->bumper_left)
+			{
+				motion_cancel();
+				drive_set_now(-50, -50);
+				serial_puts("W,Left Impact");
+				wait_ms(5000);
+				break;
+			}
+			if(sensor->bumper_right)
+			{
+				motion_cancel();
+				drive_set_now(-50, -50);
+				serial_puts("W,Right Impact");
+				wait_ms(5000);
+				break;
+			}
+			if(sensor->cliff_frontleft)
+			{
+				motion_cancel();
+				drive_set_now(-50, -50);
+				serial_puts("W,Cliff left");
+				wait_ms(5000);
+				break;
+			}
+			if(sensor->cliff_frontright)
+			{
+				motion_cancel();
+				drive_set_now(-50, -50);
+				serial_puts("W,Cliff right");
+				wait_ms(5000);
+				break;
+			}
+			///Checking for the line boundary
+			///If a boundary is found, it reverses
+			if(sensor->cliff_frontleft_signal > 500 && sensor->cliff_frontleft_signal < 2000)
+			{
+				motion_cancel();
+				drive_set_now(-50, -50);
+				serial_puts("W,line front left");
+				wait_ms(50);
+				break;
+			}
+			if(sensor->cliff_frontright_signal > 700  && sensor->cliff_frontright_signal < 2000)
+			{
+				motion_cancel();
+				drive_set_now(-50, -50);
+				serial_puts("W,line front right");
+				wait_ms(50);
+				break;
+			}
+			if(sensor->cliff_left > 500  && sensor->cliff_left < 2000)
+			{
+				motion_cancel();
+				drive_set_now(-50, -50);
+				serial_puts("W,line left signal");
+				wait_ms(50);
+				break;
+			}
+			if(sensor->cliff_right > 500  && sensor->cliff_right < 2000)
+			{
+				motion_cancel();
+				drive_set_now(-50, -50);
+				serial_puts("W,line right signal");
+				wait_ms(50);
+				break;
+			}
+			if(sensor->cliff_right_signal < 120)
+			{
+				oi_play_song(1);
+				serial_puts("WIN");
+				drive_set_now(0, 0);
+				//wait_ms(10000);
+			}
+			if(sensor->cliff_frontleft_signal < 120)
+			{
+				oi_play_song(1);
+				serial_puts("WIN");
+				drive_set_now(0, 0);
+				//wait_ms(10000);
+			}
+// 			if(sensor->cliff_frontright_signal < 0)
+// 			{
+// 				oi_play_song(1);
+// 				serial_puts("WIN");
+// 				oi_set_wheels(0,0);
+// 				wait_ms(10000);
+// 			}
+			if(sensor->cliff_left_signal < 120)
+			{
+				oi_play_song(1);
+				serial_puts("WIN");
+				drive_set_now(0, 0);
+				//wait_ms(10000);
+			}
+			oi_update(sensor);
+			battery_update(sensor);
+			dock_service(sensor);
+			motion_service(sensor);
+			route_report();
+			plan_report();
+			reflex_report();
+			
+			wait_ms(10);
+		}
+		//serial_getc();
+		/// No key pending; once the last drive key has run out, coast down to
+		/// a stop unless a motion is running
+		if(motion_status() != MOTION_RUNNING && (long) (clock_ms() - manual_until) >= 0)
+			drive_set(0, 0);
+		oi_update(sensor);
+		battery_update(sensor);
+		dock_service(sensor);
+		motion_service(sensor);
+		route_report();
+		plan_report();
+		reflex_report();
+		count = 0;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,16 @@
+/**
+*	@file	interrupt.h
+*	@brief	Host stand-in for <avr/interrupt.h>; a host program has no interrupts.
+*	@date	10/17/2026
+*/
+
+#ifndef HOST_AVR_INTERRUPT_H
+#define HOST_AVR_INTERRUPT_H
+
+#include <avr/io.h>
+
+#define ISR(vector) void vector(void); void vector(void)
+#define sei()
+#define cli()
+
+#endif
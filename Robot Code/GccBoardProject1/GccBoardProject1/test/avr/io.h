@@ -0,0 +1,30 @@
+/**
+*	@file	io.h
+*	@brief	Host stand-in for <avr/io.h>: the USART1 registers the open
+*			interface touches, as plain variables.
+*	@date	10/17/2026
+*/
+
+#ifndef HOST_AVR_IO_H
+#define HOST_AVR_IO_H
+
+#include <stdint.h>
+
+extern volatile uint8_t SREG, UBRR1H, UBRR1L, UCSR1A, UCSR1B, UCSR1C, UDR1;
+
+#define RXC		7
+#define TXC		6
+#define UDRE	5
+#define FE		4
+#define DOR		3
+#define UPE		2
+#define U2X		1
+#define RXCIE	7
+#define UDRIE	5
+#define RXEN	4
+#define TXEN	3
+#define UCSZ10	1
+#define SREG_I	7
+#define _BV(bit) (1 << (bit))
+
+#endif
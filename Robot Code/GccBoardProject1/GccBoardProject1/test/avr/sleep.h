@@ -0,0 +1,14 @@
+/**
+*	@file	sleep.h
+*	@brief	Host stand-in for <avr/sleep.h>.
+*	@date	10/17/2026
+*/
+
+#ifndef HOST_AVR_SLEEP_H
+#define HOST_AVR_SLEEP_H
+
+#define SLEEP_MODE_IDLE 0
+#define set_sleep_mode(mode)
+#define sleep_mode()
+
+#endif
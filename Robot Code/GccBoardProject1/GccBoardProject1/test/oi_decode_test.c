@@ -0,0 +1,208 @@
+/**
+*	@file	oi_decode_test.c
+*	@brief	Host check of the sensor packet decoder. Feeds a GROUP6 reply
+*			with a known value in every packet through oi_decode() and
+*			checks each oi_t field, then decodes the same bytes group by
+*			group and packet by packet and expects the same struct.
+*
+*			Build and run from this directory with the host compiler, packed
+*			like the firmware:
+*			gcc -std=gnu99 -fpack-struct -fshort-enums -I. -o oi_decode_test oi_decode_test.c && ./oi_decode_test
+*	@date	10/17/2026
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+/// The decoder is static; take the whole translation unit
+#include "../src/open_interface.c"
+
+volatile uint8_t SREG, UBRR1H, UBRR1L, UCSR1A, UCSR1B, UCSR1C, UDR1;
+
+/// What the open interface calls outside itself; the decoder needs none of it
+unsigned long clock_ms(void) { return 0; }
+void wait_ms(unsigned int time_val) { (void) time_val; }
+void drive_service(void) {}
+void drive_set_now(int16_t right_wheel, int16_t left_wheel) { (void) right_wheel; (void) left_wheel; }
+void odom_update(int16_t distance, int16_t angle) { (void) distance; (void) angle; }
+void safety_check(const oi_t *frame, unsigned long time_ms) { (void) frame; (void) time_ms; }
+void safety_service(void) {}
+
+/// A GROUP6 reply, packets 7 to 42, high byte first
+static const uint8_t group6[52] = {
+	0xE5,			// 7  bumps and wheel drops: masked to bumper right, wheel drop right
+	1, 0, 1, 0, 1,	// 8-12 wall, cliff left, front left, front right, right
+	1,				// 13 virtual wall
+	0xF3,			// 14 overcurrents: masked to ld1, ld0 and drive left
+	0x12, 0x34,		// 15, 16 unused
+	0x8A,			// 17 infrared byte
+	0xFF,			// 18 buttons: masked to play and advance
+	0xFF, 0x85,		// 19 distance -123
+	0x00, 0x2D,		// 20 angle 45
+	2,				// 21 charging state
+	0x3B, 0x82,		// 22 voltage 15234
+	0xFA, 0x56,		// 23 current -1450
+	0xFB,			// 24 temperature -5
+	0x09, 0x29,		// 25 charge 2345
+	0x0A, 0x8C,		// 26 capacity 2700
+	0x03, 0xFF,		// 27 wall signal 1023
+	0x05, 0xDD,		// 28 cliff left signal 1501
+	0x04, 0xD2,		// 29 cliff front left signal 1234
+	0x01, 0x59,		// 30 cliff front right signal 345
+	0x0F, 0xA0,		// 31 cliff right signal 4000
+	0xEA,			// 32 cargo bay inputs: masked to io1 and io3
+	0x03, 0xDB,		// 33 cargo bay voltage 987
+	0xFE,			// 34 charging sources: masked to home base
+	3,				// 35 OI mode
+	7,				// 36 song number
+	1,				// 37 song playing
+	12,				// 38 number of stream packets
+	0xFF, 0x38,		// 39 requested velocity -200
+	0xFC, 0x18,		// 40 requested radius -1000
+	0x01, 0x2C,		// 41 requested right velocity 300
+	0xFE, 0xD4		// 42 requested left velocity -300
+};
+
+/// Data bytes of each group (0-6) and packet (7-42), from the Open Interface spec
+static const uint8_t sizes[OI_SENSOR_PACKET_MAX + 1] = {
+	26, 10, 6, 10, 14, 12, 52,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 2, 2, 1, 2, 2, 1, 2, 2,
+	2, 2, 2, 2, 2, 1, 2, 1,
+	1, 1, 1, 1, 2, 2, 2, 2
+};
+
+static int failures = 0;
+
+#define CHECK(field, expected) \
+	do { \
+		if ((long) (field) != (long) (expected)) \
+		{ \
+			printf("FAIL %s: %ld, expected %ld\n", #field, (long) (field), (long) (expected)); \
+			failures++; \
+		} \
+	} while (0)
+
+/**
+*	This method checks every field of a struct decoded from group6[]
+*	@param	s			The decoded struct
+*	@param	periods		How many times the distance and angle were summed
+*	@date	10/17/2026
+*/
+static void check_fields(const oi_t *s, int periods)
+{
+	CHECK(s->bumper_right, 1);
+	CHECK(s->bumper_left, 0);
+	CHECK(s->wheeldrop_right, 1);
+	CHECK(s->wheeldrop_left, 0);
+	CHECK(s->wheeldrop_caster, 0);
+	CHECK(s->wall, 1);
+	CHECK(s->cliff_left, 0);
+	CHECK(s->cliff_frontleft, 1);
+	CHECK(s->cliff_frontright, 0);
+	CHECK(s->cliff_right, 1);
+	CHECK(s->virtual_wall, 1);
+	CHECK(s->overcurrent_ld1, 1);
+	CHECK(s->overcurrent_ld0, 1);
+	CHECK(s->overcurrent_ld2, 0);
+	CHECK(s->overcurrent_driveright, 0);
+	CHECK(s->overcurrent_driveleft, 1);
+	/// Two one byte packets, stored in order in a little endian field
+	CHECK(s->unused_bytes, 0x3412);
+	CHECK(s->infrared_byte, 0x8A);
+	CHECK(s->button_play, 1);
+	CHECK(s->button_advance, 1);
+	CHECK(s->distance, -123 * periods);
+	CHECK(s->angle, 45 * periods);
+	CHECK(s->charging_state, 2);
+	CHECK(s->voltage, 15234);
+	CHECK(s->current, -1450);
+	CHECK(s->temperature, -5);
+	CHECK(s->charge, 2345);
+	CHECK(s->capacity, 2700);
+	CHECK(s->wall_signal, 1023);
+	CHECK(s->cliff_left_signal, 1501);
+	CHECK(s->cliff_frontleft_signal, 1234);
+	CHECK(s->cliff_frontright_signal, 345);
+	CHECK(s->cliff_right_signal, 4000);
+	CHECK(s->cargo_bay_io0, 0);
+	CHECK(s->cargo_bay_io1, 1);
+	CHECK(s->cargo_bay_io2, 0);
+	CHECK(s->cargo_bay_io3, 1);
+	CHECK(s->cargo_bay_baud, 0);
+	CHECK(s->cargo_bay_voltage, 987);
+	CHECK(s->internal_charger_on, 0);
+	CHECK(s->home_base_charger_on, 1);
+	CHECK(s->oi_mode, 3);
+	CHECK(s->song_number, 7);
+	CHECK(s->song_playing, 1);
+	CHECK(s->number_packets, 12);
+	CHECK(s->requested_velocity, -200);
+	CHECK(s->requested_radius, -1000);
+	CHECK(s->requested_right_velocity, 300);
+	CHECK(s->requested_left_velocity, -300);
+}
+
+/**
+*	This method decodes a run of groups from the matching bytes of group6[]
+*	@param	s		Struct to decode into
+*	@param	first	First group ID
+*	@param	last	Last group ID
+*	@return	bytes of group6[] used
+*	@date	10/17/2026
+*/
+static uint8_t decode_groups(oi_t *s, uint8_t first, uint8_t last)
+{
+	uint8_t used = 0;
+
+	for (; first <= last; first++)
+	{
+		oi_decode(s, first, &group6[used]);
+		used += oi_packet_size(first);
+	}
+	return used;
+}
+
+int main(void)
+{
+	oi_t whole, parts;
+	uint8_t id, used;
+
+	/// Every packet's size, against the spec
+	for (id = 0; id <= OI_SENSOR_PACKET_MAX; id++)
+		CHECK(oi_packet_size(id), sizes[id]);
+	CHECK(oi_packet_size(OI_SENSOR_PACKET_MAX + 1), 0);
+
+	/// The whole reply, then once more to sum distance and angle
+	memset(&whole, 0, sizeof(whole));
+	oi_decode(&whole, OI_SENSOR_PACKET_GROUP6, group6);
+	check_fields(&whole, 1);
+	oi_decode(&whole, OI_SENSOR_PACKET_GROUP6, group6);
+	check_fields(&whole, 2);
+
+	memset(&whole, 0, sizeof(whole));
+	oi_decode(&whole, OI_SENSOR_PACKET_GROUP6, group6);
+
+	/// Groups 1-5 and groups 0, 4, 5 cover the same packets
+	memset(&parts, 0, sizeof(parts));
+	CHECK(decode_groups(&parts, 1, 5), sizeof(group6));
+	CHECK(memcmp(&parts, &whole, sizeof(oi_t)), 0);
+	memset(&parts, 0, sizeof(parts));
+	used = decode_groups(&parts, 0, 0);
+	oi_decode(&parts, 4, &group6[used]);
+	oi_decode(&parts, 5, &group6[used + oi_packet_size(4)]);
+	CHECK(memcmp(&parts, &whole, sizeof(oi_t)), 0);
+
+	/// One packet at a time, as a query list or a stream frame would send them
+	memset(&parts, 0, sizeof(parts));
+	for (id = OI_SENSOR_BUMPS_WHEELDROPS, used = 0; id <= OI_SENSOR_PACKET_MAX; id++)
+	{
+		oi_decode(&parts, id, &group6[used]);
+		used += oi_packet_size(id);
+	}
+	CHECK(used, sizeof(group6));
+	CHECK(memcmp(&parts, &whole, sizeof(oi_t)), 0);
+
+	printf(failures ? "%d failed\n" : "oi_decode: all fields ok\n", failures);
+	return failures != 0;
+}
@@ -22,11 +22,19 @@ sonar = []
 #potential location of the goal
 goalX = 3
 goalY = 7
-#stores current location
+#stores where the robot started and its current location
+startPositionX = 1
+startPositionY = 1
 currentPositionX = 1
 currentPositionY = 1
+#heading reported by the robot's odometry in degrees, counterclockwise from north
+heading = 0
 #stores angle for display
 angleVar = 0
+#set while the robot runs a queued route
+routeRunning = False
+routeStates = {1: "started", 2: "done", 3: "stopped", 4: "cancelled"}
+planStates = {0: "cancelled", 2: "found", 3: "partial", 4: "unreachable", 5: "off the map"}
 #Creates serial connection
 ser = serial.Serial('/dev/tty.ElementSerial-ElementSe', 57600, timeout = .05)
 #Creates window
@@ -58,10 +66,6 @@ def scan():
 	x = 0
 	y = 0
 	
-	currentPositionX = 1
-	currentPositionY = 1
-	
-	direction = "N"
 	#Writes space to the robot to start scan
 	ser.write(" ".encode())
 	
@@ -96,10 +100,11 @@ def scan():
 			#Prints x, y cords
 			print(x, y)	
 			
-			if(direction == 'N'):
-				print("North")
-				x = x + currentPositionX
-				y = y + currentPositionY
+			#Rotates by the robot's heading and moves to its position
+			h = math.radians(heading)
+			x, y = x * math.cos(h) - y * math.sin(h), x * math.sin(h) + y * math.cos(h)
+			x = x + currentPositionX
+			y = y + currentPositionY
 			#Plots objects to graph and redraws the graph
 			movementA.plot(x, y, 'bo') 	
 			movementcanvas.draw()
@@ -109,6 +114,9 @@ def scan():
 		
 #Updates data on the graph	
 def update_data():
+	global currentPositionX
+	global currentPositionY
+	global heading
 	#deletes data in arrays
 	del deg[:]
 	del ir[:]
@@ -144,6 +152,16 @@ def update_data():
 		if(data.startswith("S")):
 			speedSetting.set(data.strip('S,'))
 			
+		#odometry pose in mm and degrees; the robot starts facing north
+		if(data.startswith("PX")):
+			currentPositionY = startPositionY + float(data.strip('PX,')) / 1000
+			
+		if(data.startswith("PY")):
+			currentPositionX = startPositionX - float(data.strip('PY,')) / 1000
+			
+		if(data.startswith("PH")):
+			heading = float(data.strip('PH,'))
+			
 		if(data.startswith("DEG")):
 			deg.append(data.strip('DEG,'))
 			
@@ -229,6 +247,90 @@ def inputProcessing():
 			
 		angleData.set(angleVar)
 		
+#Sends a batch of motions to the robot's queue in one message, e.g. "m500;t90;g1000,500"
+#m moves (mm), t turns (degrees, counterclockwise), h turns to a heading, a<radius>,<degrees> 
+#drives an arc, g<x>,<y> drives to a point in mm from where odometry started and v<speed>
+#sets the speed of the steps after it. p<x>,<y> points in a row make a path the robot
+#follows without stopping at the corners; l<mm> sets how far ahead along it the robot aims.
+#A point the map shows something in front of is reached the way the robot plans around it;
+#c<mm> sets the cell size of the plans. Sending again while a route runs adds to it.
+def sendRoute():
+	global routeRunning
+	ser.write(("r" + routeCommand.get() + "\n").encode())
+	#The robot answers with MA, the id of the first step, how many it queued and how many wait
+	input = ser.readline().decode().strip('\r\n')
+	print(input)
+	if(input.startswith("MA")):
+		routeStatus.set(input)
+		if(not routeRunning):
+			routeRunning = True
+			top.after(50, followRoute)
+
+#Drops the steps still waiting; the robot cancels the one it is running
+def flushRoute():
+	ser.write("f".encode())
+
+#Follows the queue while a route runs without blocking the window, so Flush still works
+def followRoute():
+	global routeRunning
+	global currentPositionX
+	global currentPositionY
+	global heading
+	while(ser.inWaiting() > 0):
+		input = ser.readline().decode().strip('\r\n')
+		print(input)
+		#MQ,id,status,queued,x,y,heading when a step starts (1) or ends (2 done, 3 stopped, 4 cancelled)
+		if(input.startswith("MQ")):
+			step, status, queued, x, y, h = [int(n) for n in input.strip('MQ,').split(',')]
+			currentPositionY = startPositionY + x / 1000.0
+			currentPositionX = startPositionX - y / 1000.0
+			heading = h
+			movementA.plot(currentPositionX, currentPositionY, 'g.')
+			movementcanvas.draw()
+			routeStatus.set("Step %d %s, %d waiting" % (step, routeStates.get(status, status), queued))
+			if(status != 1 and queued == 0):
+				routeRunning = False
+		if(input.startswith("W")):
+			check_warning(input)
+		#The safety reflex stopped the robot, which also empties the queue
+		if(input.startswith("RF")):
+			warningText.set("Reflex stop " + input.strip('RF,'))
+		#PN,status,size,reached,waves,ticks,ms,points,restarts: a waypoint planned its way around
+		if(input.startswith("PN")):
+			status, size, reached, waves, ticks, ms, points, restarts = [int(n) for n in input.strip('PN,').split(',')]
+			routeStatus.set("Plan %s on %dx%d: %d steps, %d waypoints in %d ms" % (planStates.get(status, status), size, size, waves, points, ms))
+	if(routeRunning):
+		top.after(50, followRoute)
+
+#Asks the robot for its occupancy grid and plots what it has seen: GM gives the size, the
+#cell size and the corner of cell 0,0 in mm, each GR a row of cells in hex, 2 bits a cell
+def showMap():
+	ser.write("o".encode())
+	size = 0
+	cell = 0
+	originX = 0
+	originY = 0
+	while True:
+		input = ser.readline().decode().strip('\r\n')
+		if(input.startswith("GM")):
+			size, cell, originX, originY = [int(n) for n in input.strip('GM,').split(',')]
+		if(input.startswith("GR")):
+			row, cells = input.strip('GR,').split(',')
+			#odometry y of the middle of the row
+			y = originY + (int(row) + 0.5) * cell
+			for i in range(0, len(cells) // 2):
+				byte = int(cells[2 * i:2 * i + 2], 16)
+				for k in range(0, 4):
+					state = (byte >> (2 * k)) & 3
+					#2 seen once, 3 seen more often; 1 is free and 0 unknown
+					if(state >= 2):
+						x = originX + (4 * i + k + 0.5) * cell
+						movementA.plot(startPositionX - y / 1000.0, startPositionY + x / 1000.0, 'ks' if state == 3 else 'ys', markersize=2)
+		#A lost line must not hang the window
+		if(input == "GE" or input == ""):
+			break
+	movementcanvas.draw()
+
 #Reads test data in from a local file
 def readFile():
 	i = 0
@@ -326,6 +428,8 @@ lineRight = StringVar()
 speedSetting = StringVar()
 warningText = StringVar()
 angleData = StringVar()
+routeCommand = StringVar()
+routeStatus = StringVar()
 
 #Creates frame elements for UI
 page = Frame(top, bg="Gray")
@@ -449,5 +553,21 @@ B1.grid(row=20,column=9)
 clearbutton = Tkinter.Button(sensors, text = "Clear", command = clear, bg = "Gray")
 clearbutton.grid(row=20, column = 8)
 
+mapbutton = Tkinter.Button(sensors, text = "Map", command = showMap, bg="Gray")
+mapbutton.grid(row=20, column=10)
+
+#Route queue: a batch of motions, sent in one message
+routeEntry = Entry(sensors, textvariable=routeCommand, width=30)
+routeEntry.grid(row=21, column=4, columnspan=3)
+
+runRoute = Tkinter.Button(sensors, text = "Run Route", command = sendRoute, bg="Gray")
+runRoute.grid(row=21, column=7)
+
+flush = Tkinter.Button(sensors, text = "Flush", command = flushRoute, bg="Gray")
+flush.grid(row=21, column=8)
+
+routeLabel = Label(sensors, textvariable=routeStatus, bg="Gray")
+routeLabel.grid(row=22, column=4, columnspan=5)
+
 #Runs user interface
 top.mainloop()